@@ -53,6 +53,46 @@
 #endif
 
 #include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Alarm.h"
+
+/** Phases of the startup sequence */
+enum { MPRLS_POWER_IDLE, MPRLS_POWER_RESET, MPRLS_POWER_STARTUP };
+
+Adafruit_MPRLS_Base
+    *Adafruit_MPRLS_Base::_eocInstances[MPRLS_MAX_EOC_INTERRUPTS] = {
+        NULL, NULL, NULL, NULL};
+
+/** Pressure unit letters of Honeywell MPR part numbers, in PSI per unit */
+static const struct {
+  char code;
+  float psi;
+} mprls_units[] = {
+    {'P', 1.0}, {'K', 0.145037738}, {'B', 14.5037738}, {'M', 0.0145037738}};
+
+/** Transfer function letters of Honeywell MPR part numbers, in % of counts */
+static const struct {
+  char code;
+  float outputMin, outputMax;
+} mprls_curves[] = {{'A', 10, 90}, {'B', 2.5, 22.5}, {'C', 20, 80}};
+
+/*! @brief Turn a transfer function limit in % into counts
+ *  @param percent Percentage of 2^24 @returns Counts */
+static uint32_t percentToCounts(float percent) {
+  return (uint32_t)((float)COUNTS_224 * (percent / 100.0) + 0.5);
+}
+
+/**************************************************************************/
+/*!
+    @brief constructor for the bus and timing side of a sensor
+    @param reset_pin Optional hardware reset pin, -1 to skip
+    @param EOC_pin Optional End-of-Convert indication pin, -1 to skip
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Base::Adafruit_MPRLS_Base(int8_t reset_pin, int8_t EOC_pin)
+    : _i2c_device(MPRLS_DEFAULT_ADDR, &Wire) {
+  _reset = reset_pin;
+  _eoc = EOC_pin;
+}
 
 /**************************************************************************/
 /*!
@@ -71,15 +111,111 @@
 /**************************************************************************/
 Adafruit_MPRLS::Adafruit_MPRLS(int8_t reset_pin, int8_t EOC_pin,
                                uint16_t PSI_min, uint16_t PSI_max,
-                               float OUTPUT_min, float OUTPUT_max, float K) {
+                               float OUTPUT_min, float OUTPUT_max, float K)
+    : Adafruit_MPRLS_Base(reset_pin, EOC_pin) {
+  _PSI_min = PSI_min;
+  _PSI_max = PSI_max;
+  _OUTPUT_min = percentToCounts(OUTPUT_min);
+  _OUTPUT_max = percentToCounts(OUTPUT_max);
+  _K = K;
+
+  computeCoefficients();
+}
+
+/**************************************************************************/
+/*!
+    @brief destructor, releases the EOC interrupt if one was attached
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Base::~Adafruit_MPRLS_Base(void) { disableEOCInterrupt(); }
+
+/**************************************************************************/
+/*!
+    @brief Change the pressure range and transfer function curve in place,
+   e.g. once a part has been identified at runtime. Only the conversion
+   coefficients are recomputed, no bus access is made. Don't call this while
+   another task is converting readings of this sensor. Adafruit_MPRLS_T
+   keeps converting with its compile-time curve
+    @param PSI_min Pressure at OUTPUT_min, negative for compound ranges
+    @param PSI_max Pressure at OUTPUT_max
+    @param OUTPUT_min The minimum transfer function curve value in %
+    @param OUTPUT_max The maximum transfer function curve value in %
+    @returns True on success, False (nothing changed) if the ranges are empty
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS::setTransferFunction(float PSI_min, float PSI_max,
+                                         float OUTPUT_min, float OUTPUT_max) {
+  uint32_t outMin = percentToCounts(OUTPUT_min);
+  uint32_t outMax = percentToCounts(OUTPUT_max);
+  if (PSI_min == PSI_max || outMin == outMax)
+    return false;
 
-  _reset = reset_pin;
-  _eoc = EOC_pin;
   _PSI_min = PSI_min;
   _PSI_max = PSI_max;
-  _OUTPUT_min = (uint32_t)((float)COUNTS_224 * (OUTPUT_min / 100.0) + 0.5);
-  _OUTPUT_max = (uint32_t)((float)COUNTS_224 * (OUTPUT_max / 100.0) + 0.5);
+  _OUTPUT_min = outMin;
+  _OUTPUT_max = outMax;
+  computeCoefficients();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Change the units readings are converted to, in place
+    @param K Conversion factor from PSI to the desired units, e.g. PSI_to_HPA
+*/
+/**************************************************************************/
+void Adafruit_MPRLS::setUnits(float K) {
   _K = K;
+  computeCoefficients();
+}
+
+/**************************************************************************/
+/*!
+    @brief Set the pressure range and transfer function from a Honeywell MPR
+   series part number such as "MPRLS0025PA00001A". The range is the four
+   digits and unit letter (P psi, K kPa, B bar, M mbar), then A(bsolute) or
+   G(auge) for a range from 0, or D(ifferential) for -range to +range. The
+   last letter is the curve: A 10-90%, B 2.5-22.5%, C 20-80% of 2^24 counts.
+   The "MPR" prefix and package letters are optional. The units set with
+   setUnits() or the constructor are kept
+    @param partNumber The part number
+    @returns True on success, False (nothing changed) if it wasn't understood
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS::setProfile(const char *partNumber) {
+  const char *p = partNumber;
+  if (!strncmp(p, "MPR", 3))
+    p += 3;
+  while (isalpha(*p))
+    p++; // package
+
+  uint16_t range = 0;
+  for (uint8_t i = 0; i < 4; i++, p++) {
+    if (!isdigit(*p))
+      return false;
+    range = range * 10 + (*p - '0');
+  }
+
+  float psi = 0;
+  for (uint8_t i = 0; i < sizeof(mprls_units) / sizeof(mprls_units[0]); i++)
+    if (toupper(*p) == mprls_units[i].code)
+      psi = range * mprls_units[i].psi;
+  if (psi == 0)
+    return false;
+  p++;
+
+  char type = toupper(*p++);
+  if (type != 'A' && type != 'G' && type != 'D')
+    return false;
+
+  while (isdigit(*p))
+    p++; // address and options
+  for (uint8_t i = 0; i < sizeof(mprls_curves) / sizeof(mprls_curves[0]); i++)
+    if (toupper(*p) == mprls_curves[i].code)
+      return setTransferFunction(type == 'D' ? -psi : 0, psi,
+                                 mprls_curves[i].outputMin,
+                                 mprls_curves[i].outputMax);
+  return false;
 }
 
 /**************************************************************************/
@@ -91,29 +227,159 @@ Adafruit_MPRLS::Adafruit_MPRLS(int8_t reset_pin, int8_t EOC_pin,
     @returns True on success, False if sensor not found
 */
 /**************************************************************************/
-boolean Adafruit_MPRLS::begin(uint8_t i2c_addr, TwoWire *twoWire) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(i2c_addr, twoWire);
-  if (!i2c_dev->begin())
+boolean Adafruit_MPRLS_Base::begin(uint8_t i2c_addr, TwoWire *twoWire) {
+  if (!setupBus(i2c_addr, twoWire))
+    return false;
+
+  return powerUp();
+}
+
+/**************************************************************************/
+/*!
+    @brief Start setting up the hardware without waiting for the reset and
+   startup timing, so many sensors can be brought up in parallel. Call
+   pollBegin() until it stops returning MPRLS_BEGIN_PENDING
+    @param i2c_addr The I2C address for the sensor (default is 0x18)
+    @param twoWire Optional pointer to the desired TwoWire I2C object. Defaults
+   to &Wire
+    @returns True if the startup was started, False if sensor not found
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::beginAsync(uint8_t i2c_addr, TwoWire *twoWire) {
+  if (!setupBus(i2c_addr, twoWire))
     return false;
 
+  return resetAsync();
+}
+
+/**************************************************************************/
+/*!
+    @brief Non-blocking version of reset(), call pollBegin() until it stops
+   returning MPRLS_BEGIN_PENDING. Reads fail as unhealthy until then
+    @returns True, the sequence always starts
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::resetAsync(void) {
+  _converting = false;
+  _haveData = false;
+  _healthy = false;
+
+  _powerStart = micros();
   if (_reset != -1) {
-    pinMode(_reset, OUTPUT);
-    digitalWrite(_reset, HIGH);
     digitalWrite(_reset, LOW);
-    delay(10);
-    digitalWrite(_reset, HIGH);
+    _powerPhase = MPRLS_POWER_RESET;
+    _powerWait = MPRLS_RESET_PULSE_MS * 1000UL;
+  } else {
+    _powerPhase = MPRLS_POWER_STARTUP;
+    _powerWait = MPRLS_STARTUP_MS * 1000UL;
   }
-  if (_eoc != -1) {
-    pinMode(_eoc, INPUT);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Advance the startup sequence started by beginAsync() or
+   resetAsync(), never blocks
+    @returns MPRLS_BEGIN_PENDING until the sensor has had time to start,
+   then whether it reports powered
+*/
+/**************************************************************************/
+mprls_begin_t Adafruit_MPRLS_Base::pollBegin(void) {
+  if (_powerPhase == MPRLS_POWER_IDLE)
+    return _healthy ? MPRLS_BEGIN_OK : MPRLS_BEGIN_FAILED;
+
+  uint32_t now = micros();
+  if (now - _powerStart < _powerWait)
+    return MPRLS_BEGIN_PENDING;
+
+  if (_powerPhase == MPRLS_POWER_RESET) {
+    digitalWrite(_reset, HIGH);
+    _powerPhase = MPRLS_POWER_STARTUP;
+    _powerStart = now;
+    _powerWait = MPRLS_STARTUP_MS * 1000UL; // startup timing
+    return MPRLS_BEGIN_PENDING;
   }
 
-  delay(10); // startup timing
+  _powerPhase = MPRLS_POWER_IDLE;
 
   // Serial.print("Status: ");
   // Serial.println(stat);
-  return ((readStatus() & MPRLS_STATUS_MASK) == MPRLS_STATUS_POWERED);
+  lastStatus = readStatus();
+  if ((lastStatus & MPRLS_STATUS_MASK) != MPRLS_STATUS_POWERED)
+    return MPRLS_BEGIN_FAILED;
+
+  _healthy = true;
+  _failures = 0;
+  return MPRLS_BEGIN_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief Quick recovery of a sensor that begin() already succeeded on:
+   pulses the reset pin if there is one and checks the sensor comes back
+   powered, without setting the I2C device up again. Waits go through the
+   sleep callback if one is set
+    @returns True if the sensor reports powered (it is then marked healthy)
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::reset(void) { return powerUp(); }
+
+/**************************************************************************/
+/*!
+    @brief Blocking run of the reset and startup sequence
+    @returns True if the sensor reports powered and no other status bits
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::powerUp(void) {
+  mprls_begin_t state;
+
+  resetAsync();
+  while ((state = pollBegin()) == MPRLS_BEGIN_PENDING) {
+    uint32_t elapsed = micros() - _powerStart;
+    if (elapsed < _powerWait)
+      idle(_powerWait - elapsed);
+  }
+  return state == MPRLS_BEGIN_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief I2C and pin setup shared by begin() and beginAsync()
+    @param i2c_addr The I2C address for the sensor
+    @param twoWire The TwoWire I2C object
+    @returns True if the sensor answered on the bus
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::setupBus(uint8_t i2c_addr, TwoWire *twoWire) {
+  // not usable until the startup has seen it powered
+  _healthy = false;
+  _powerPhase = MPRLS_POWER_IDLE;
+
+  if (_transport) {
+    if (!_transport->begin())
+      return false;
+  } else {
+    // reuse the embedded device so begin() can be called again without
+    // touching the heap
+    _i2c_device = Adafruit_I2CDevice(i2c_addr, twoWire);
+    i2c_dev = &_i2c_device;
+    if (!i2c_dev->begin())
+      return false;
+  }
+
+#ifdef MPRLS_ENABLE_STATS
+  resetStats();
+#endif
+
+  if (_reset != -1) {
+    pinMode(_reset, OUTPUT);
+    digitalWrite(_reset, HIGH);
+  }
+  // a transport that drives EOC itself has no pin to set up
+  if (_eoc != -1 && !(_transport && _transport->eocLevel() >= 0)) {
+    pinMode(_eoc, INPUT);
+  }
+  return true;
 }
 
 /**************************************************************************/
@@ -123,64 +389,703 @@ boolean Adafruit_MPRLS::begin(uint8_t i2c_addr, TwoWire *twoWire) {
 
 */
 /**************************************************************************/
-float Adafruit_MPRLS::readPressure(void) {
-  uint32_t raw_psi = readData();
-  if (raw_psi == 0xFFFFFFFF || _OUTPUT_min == _OUTPUT_max) {
+float Adafruit_MPRLS::readPressure(void) { return convertRaw(readData()); }
+
+/**************************************************************************/
+/*!
+    @brief Convert a raw reading to pressure using the transfer function
+   curve and conversion factor given to the constructor. These are folded
+   into a gain and offset up front, so this is a single multiply-add
+    @param raw 24 bits of raw ADC reading, e.g. logged earlier
+    @returns The pressure in the units set by K, NAN if raw is 0xFFFFFFFF
+*/
+/**************************************************************************/
+float Adafruit_MPRLS::convertRaw(uint32_t raw) {
+  if (raw == 0xFFFFFFFF)
     return NAN;
+
+  // use the 10-90 calibration curve by default or whatever provided by the
+  // user, converted to desired units using provided factor
+  return (float)raw * _gain + _offset;
+}
+
+/**************************************************************************/
+/*!
+    @brief Convert a whole buffer of raw readings in one go, e.g. samples
+   stored by a logger that only kept the raw counts
+    @param raw Array of raw readings, 0xFFFFFFFF entries convert to NAN
+    @param pressure Array of count elements for the results, in the units
+   set by K. May not overlap raw
+    @param count Number of readings
+*/
+/**************************************************************************/
+void Adafruit_MPRLS::convertRaw(const uint32_t *raw, float *pressure,
+                                size_t count) {
+  float gain = _gain, offset = _offset;
+  for (size_t i = 0; i < count; i++) {
+    pressure[i] = (raw[i] == 0xFFFFFFFF) ? NAN : (float)raw[i] * gain + offset;
   }
+}
+
+/**************************************************************************/
+/*!
+    @brief Read and calculate the pressure without any floating point math,
+   for MCUs without an FPU
+    @returns The measured pressure in the units set by K as a Q16.16 fixed
+   point value (divide by 65536.0 for the real value), or MPRLS_FIXED_INVALID
+   on failure or if the full scale does not fit in Q16.16
+*/
+/**************************************************************************/
+int32_t Adafruit_MPRLS::readPressureFixed(void) {
+  return convertRawFixed(readData());
+}
+
+/**************************************************************************/
+/*!
+    @brief Convert a raw reading with the fixed point coefficients
+   precomputed from the transfer function. The product is built from 16x16
+   bit multiplies and constant shifts, which 8 bit AVRs and Cortex-M0 do in
+   a few instructions, rather than a 64 bit multiply and a variable shift
+   that would end up in libgcc helpers
+    @param raw 24 bits of raw ADC reading
+    @returns The pressure as Q16.16 in the units set by K, or
+   MPRLS_FIXED_INVALID
+*/
+/**************************************************************************/
+int32_t Adafruit_MPRLS::convertRawFixed(uint32_t raw) {
+  if (raw == 0xFFFFFFFF || _fixedGain == 0)
+    return MPRLS_FIXED_INVALID;
+
+  // counts * gain is Q16.16 scaled up by 2^24, round it back down. With
+  // raw = rh * 2^16 + rl and gain = gh * 2^16 + gl the product is
+  // rh * gh * 2^32 + (rh * gl + rl * gh) * 2^16 + rl * gl
+  uint32_t gain = _fixedGain < 0 ? -(uint32_t)_fixedGain : _fixedGain;
+  uint16_t gainHigh = gain >> 16, gainLow = gain;
+  uint8_t rawHigh = raw >> 16;
+  uint16_t rawLow = raw;
 
-  // All is good, calculate and convert to desired units using provided factor
-  // use the 10-90 calibration curve by default or whatever provided by the user
-  float psi = (raw_psi - _OUTPUT_min) * (_PSI_max - _PSI_min);
-  psi /= (float)(_OUTPUT_max - _OUTPUT_min);
-  psi += _PSI_min;
-  // convert to desired units
-  return psi * _K;
+  // everything from 2^16 up, the bits below can't reach the rounded result
+  uint32_t middle = (uint32_t)rawHigh * gainLow + (uint32_t)rawLow * gainHigh +
+                    (((uint32_t)rawLow * gainLow) >> 16);
+  uint32_t scaled =
+      (((uint32_t)rawHigh * gainHigh) << 8) + ((middle + 0x80) >> 8);
+  return (_fixedGain < 0 ? -(int32_t)scaled : (int32_t)scaled) + _fixedOffset;
 }
 
 /**************************************************************************/
 /*!
-    @brief Read 24 bits of measurement data from the device
+    @brief Fixed point version of the batch conversion
+    @param raw Array of raw readings
+    @param pressure Array of count elements for the Q16.16 results, failed
+   readings come out as MPRLS_FIXED_INVALID
+    @param count Number of readings
+*/
+/**************************************************************************/
+void Adafruit_MPRLS::convertRawFixed(const uint32_t *raw, int32_t *pressure,
+                                     size_t count) {
+  for (size_t i = 0; i < count; i++)
+    pressure[i] = convertRawFixed(raw[i]);
+}
+
+/**************************************************************************/
+/*!
+    @brief Fold the transfer function and unit conversion into the gain and
+   offset used at runtime, so no division is left in the per-sample path
+*/
+/**************************************************************************/
+void Adafruit_MPRLS::computeCoefficients(void) {
+  _gain = NAN;
+  _offset = 0;
+  _fixedGain = 0;
+  _fixedOffset = 0;
+
+  if (_OUTPUT_max == _OUTPUT_min)
+    return;
+
+  double gain = ((double)_PSI_max - _PSI_min) * _K /
+                ((double)_OUTPUT_max - (double)_OUTPUT_min);
+  double offset = (double)_PSI_min * _K - (double)_OUTPUT_min * gain;
+  _gain = gain;
+  _offset = offset;
+
+  // the whole 24 bit range has to fit in Q16.16
+  if (fabs(gain) * COUNTS_224 + fabs(offset) >= 32767.0)
+    return;
+
+  // with the full scale below 2^31 in Q16.16, the gain scaled up by another
+  // 2^24 still fits in 31 bits, and the rounding of it costs at most half
+  // an LSB over the 24 bit range
+  double scaled = gain * 65536.0 * COUNTS_224;
+  _fixedGain = (int32_t)(scaled + (scaled < 0 ? -0.5 : 0.5));
+  _fixedOffset = (int32_t)(offset * 65536.0 + (offset < 0 ? -0.5 : 0.5));
+}
+
+/**************************************************************************/
+/*!
+    @brief Read 24 bits of measurement data from the device, blocking until
+   the conversion completes or times out. Use this to store raw counts and
+   convert them later with convertRaw()
     @returns -1 on failure (check status) or 24 bits of raw ADC reading
 */
 /**************************************************************************/
-uint32_t Adafruit_MPRLS::readData(void) {
-  uint8_t buffer[4] = {0xAA, 0, 0, 0};
+uint32_t Adafruit_MPRLS_Base::readData(void) { return readResult().raw; }
 
-  // Request data
-  i2c_dev->write(buffer, 3);
+/**************************************************************************/
+/*!
+    @brief Blocking read that reports why it failed, so callers can decide
+   to retry, skip or reset without reading the status again
+    @returns The raw reading together with the error code and status byte
+*/
+/**************************************************************************/
+mprls_result_t Adafruit_MPRLS_Base::readResult(void) {
+  mprls_result_t result = {0xFFFFFFFF, MPRLS_OK, 0};
 
-  // Use the gpio to tell end of conversion
-  uint32_t t = millis();
-  if (_eoc != -1) {
-    while (!digitalRead(_eoc)) {
-      if (millis() - t > MPRLS_READ_TIMEOUT)
-        return 0xFFFFFFFF; // timeout
+  if (!startConversion()) {
+    result.error = _lastError;
+    result.status = lastStatus;
+    return result;
+  }
+
+  return finishConversion();
+}
+
+/**************************************************************************/
+/*!
+    @brief Wait for the conversion in flight and read it, with the same
+   polling strategy (or EOC sleep) whoever started it
+    @returns The raw reading together with the error code and status byte
+*/
+/**************************************************************************/
+mprls_result_t Adafruit_MPRLS_Base::finishConversion(void) {
+  mprls_result_t result = {0xFFFFFFFF, MPRLS_OK, 0};
+
+  if (_eoc == -1) {
+    // every poll is a bus transaction, so sleep through most of the
+    // conversion and then only poll every so often
+    uint32_t elapsed = micros() - _convStart;
+    if (elapsed < _initialWait)
+      idle(capWait(_initialWait - elapsed));
+    while (!isReady()) {
+      if (!_converting || checkTimeout())
+        break;
+      idle(capWait(_pollInterval));
     }
   } else {
-    // check the status byte
-    //    uint8_t stat;
-    while ((lastStatus = readStatus()) & MPRLS_STATUS_BUSY) {
-      // Serial.print("Status: "); Serial.println(stat, HEX);
-      if (millis() - t > MPRLS_READ_TIMEOUT)
-        return 0xFFFFFFFF; // timeout
+    while (!isReady()) {
+      if (!_converting || checkTimeout())
+        break;
+      // with the interrupt the EOC edge wakes us, so sleep until then
+      uint32_t elapsed = micros() - _convStart;
+      if (_eocSlot != -1 && _sleep && elapsed < _timeout)
+        _sleep(_timeout - elapsed, _sleepArg);
+    }
+  }
+
+  if (!_converting) { // timed out or the bus failed
+    result.error = _lastError;
+    result.status = lastStatus;
+    return result;
+  }
+
+  fetchResult(&result);
+  return result;
+}
+
+/**************************************************************************/
+/*!
+    @brief Shorten a wait so it doesn't run past the conversion timeout
+    @param us The wait wanted, in microseconds
+    @returns The wait, at most until checkTimeout() gives up
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Base::capWait(uint32_t us) {
+  uint32_t elapsed = micros() - _convStart;
+  // checkTimeout() gives up once more than _timeout has passed
+  uint32_t left = elapsed <= _timeout ? _timeout - elapsed + 1 : 0;
+  return us < left ? us : left;
+}
+
+/**************************************************************************/
+/*!
+    @brief Blocking read of a timestamped sample record
+    @param sample Filled in with the reading, the micros() time the
+   conversion was seen complete, its sequence number and the status byte
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::readSample(mprls_sample_t *sample) {
+  mprls_result_t result = readResult();
+  fillSample(sample, result);
+  return result.error == MPRLS_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief Run several conversions back to back and combine the raw counts
+   with integer math only
+    @param samples Number of conversions to run, 1 to 255
+    @param mode How to combine them, see mprls_average_t
+    @returns The combined 24 bit raw reading, 0xFFFFFFFF if every
+   conversion failed
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Base::readRawOversampled(uint8_t samples,
+                                                 mprls_average_t mode) {
+  uint32_t sum;
+  uint8_t count = oversample(samples, mode, &sum);
+  if (count == 0)
+    return 0xFFFFFFFF;
+  return (sum + count / 2) / count;
+}
+
+/**************************************************************************/
+/*!
+    @brief Run several conversions back to back and convert their combined
+   raw counts once. Keeps the fractional counts of the average, so the
+   resolution improves with the number of samples
+    @param samples Number of conversions to run, 1 to 255
+    @param mode How to combine them, see mprls_average_t
+    @returns The pressure in the units set by K, NAN if every conversion
+   failed
+*/
+/**************************************************************************/
+float Adafruit_MPRLS::readPressureAveraged(uint8_t samples,
+                                           mprls_average_t mode) {
+  uint32_t sum;
+  uint8_t count = oversample(samples, mode, &sum);
+  if (count == 0)
+    return NAN;
+  // the sum can be longer than a float's 24 bit mantissa, convert the whole
+  // counts of the mean and add the fraction on its own so it isn't lost
+  return (float)(sum / count) * _gain + _offset +
+         (float)(sum % count) / count * _gain;
+}
+
+/**************************************************************************/
+/*!
+    @brief Collect samples for the oversampled reads. Failed conversions
+   are skipped
+    @param samples Number of conversions to run
+    @param mode How to combine them
+    @param sum Set to the sum of the raw counts that make up the result
+    @returns How many counts were summed, 0 if there is no result
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Base::oversample(uint8_t samples, mprls_average_t mode,
+                                        uint32_t *sum) {
+  uint32_t sorted[MPRLS_MEDIAN_MAX_SAMPLES];
+  uint32_t lowest = 0xFFFFFFFF, highest = 0;
+  uint8_t count = 0;
+
+  if (mode == MPRLS_AVERAGE_MEDIAN && samples > MPRLS_MEDIAN_MAX_SAMPLES)
+    samples = MPRLS_MEDIAN_MAX_SAMPLES;
+
+  *sum = 0; // 255 * 2^24 still fits
+  for (uint8_t i = 0; i < samples; i++) {
+    uint32_t raw = readData();
+    if (raw == 0xFFFFFFFF)
+      continue;
+
+    if (mode == MPRLS_AVERAGE_MEDIAN) {
+      // insertion sort as we go, the list is short
+      uint8_t j = count;
+      while (j > 0 && sorted[j - 1] > raw) {
+        sorted[j] = sorted[j - 1];
+        j--;
+      }
+      sorted[j] = raw;
     }
+    if (raw < lowest)
+      lowest = raw;
+    if (raw > highest)
+      highest = raw;
+    *sum += raw;
+    count++;
+  }
+
+  if (mode == MPRLS_AVERAGE_MEDIAN && count > 0) {
+    if (count & 1) {
+      *sum = sorted[count / 2];
+      return 1;
+    }
+    *sum = sorted[count / 2 - 1] + sorted[count / 2];
+    return 2;
+  }
+  if (mode == MPRLS_AVERAGE_TRIMMED && count > 2) {
+    *sum -= lowest + highest;
+    return count - 2;
+  }
+  return count;
+}
+
+/**************************************************************************/
+/*!
+    @brief Send the measurement command and return without waiting for the
+   conversion to complete. Use isReady() to check for completion and
+   fetchResult() to read the data.
+    @returns True if the command was sent, False on I2C failure or if the
+   sensor is marked unhealthy (no bus access is made then)
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::startConversion(void) {
+  uint8_t buffer[3] = {0xAA, 0, 0};
+
+  if (!prepareConversion())
+    return false;
+
+  // Request data
+  if (!busWrite(buffer, 3)) {
+    _converting = false;
+    _lastError = MPRLS_ERR_I2C;
+    recordFailure();
+    return false;
+  }
+  _convStart = micros();
+  _converting = true;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Reset the per-conversion state before a measurement command
+    @returns False (with lastError set) if the sensor is marked unhealthy
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::prepareConversion(void) {
+  // every attempt gets its own number and time, so a failed one still shows
+  // up as a gap in the sequence
+  _sequence++;
+  _stamped = false;
+
+  // fail fast, don't let a dead sensor eat bus time or the caller's timeout,
+  // but check on it now and then so it comes back once the bus works again
+  if (!_healthy && !retryProbe()) {
+    _lastError = MPRLS_ERR_UNHEALTHY;
+    return false;
+  }
+
+  _eocFlag = false;
+  _haveData = false;
+  _polls = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Use a transport instead of the built in I2C device for all bus
+   access. Call before begin()
+    @param transport The transport, NULL to go back to the I2C device
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setTransport(Adafruit_MPRLS_Transport *transport) {
+  _transport = transport;
+}
+
+/**************************************************************************/
+/*!
+    @brief Like startConversion() but hands the command to the transport's
+   background write so the CPU is free while it goes out. Without a
+   transport, or with one that has no asynchronous support, this is the same
+   as startConversion()
+    @returns True if the command was started and hasn't failed yet. A
+   failure is counted towards the failure threshold once, however it is
+   reported
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::startConversionAsync(void) {
+  // must outlive this call, the transfer may still be running on return
+  static const uint8_t command[3] = {0xAA, 0, 0};
+
+  if (!_transport)
+    return startConversion();
+  if (!prepareConversion())
+    return false;
+
+  // the conversion starts when the command lands, which is close enough to
+  // now for the timeout
+  _convStart = micros();
+  _converting = true;
+  if (!_transport->writeAsync(command, 3, asyncWriteDone, this)) {
+    // never started, so the callback won't count the failure
+    _converting = false;
+    _lastError = MPRLS_ERR_I2C;
+    recordFailure();
+    return false;
+  }
+  // false if the write already finished and failed, counted by the callback
+  return _converting;
+}
+
+/**************************************************************************/
+/*!
+    @brief Start a background read of a completed conversion. When the
+   callback reports success, fetchResult() decodes the captured bytes without
+   touching the bus. If the read failed fetchResult() tries again blocking
+    @param callback Called once the data has arrived, possibly from an ISR
+    @param arg Pointer passed through to the callback
+    @returns True if the read was started, the callback then reports how it
+   went (possibly before this returns). False if it could not be started,
+   the callback is not called then
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::fetchResultAsync(MPRLS_TransferCallback callback,
+                                           void *arg) {
+  // a merged poll may already have the data
+  if (_haveData || !_transport) {
+    bool ok = _haveData || fetchRaw();
+    if (callback)
+      callback(ok, arg);
+    return true;
+  }
+
+  _asyncCallback = callback;
+  _asyncArg = arg;
+  if (!_transport->readAsync(_data, 4, asyncReadDone, this)) {
+    _lastError = MPRLS_ERR_I2C;
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Blocking read of the result bytes into the capture buffer
+    @returns True if the read succeeded
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::fetchRaw(void) {
+  _haveData = busRead(_data, 4);
+  return _haveData;
+}
+
+/**************************************************************************/
+/*!
+    @brief Transport completion for startConversionAsync()
+    @param ok True if the command was sent
+    @param arg The sensor
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::asyncWriteDone(bool ok, void *arg) {
+  Adafruit_MPRLS_Base *self = (Adafruit_MPRLS_Base *)arg;
+  MPRLS_STAT(self->_stats.i2cTransfers++);
+  if (ok) {
+    MPRLS_STAT(self->_stats.i2cBytes += 3);
+    return;
+  }
+  MPRLS_STAT(self->_stats.i2cErrors++);
+  self->_converting = false;
+  self->_lastError = MPRLS_ERR_I2C;
+  self->recordFailure();
+}
+
+/**************************************************************************/
+/*!
+    @brief Transport completion for fetchResultAsync()
+    @param ok True if the data was read
+    @param arg The sensor
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::asyncReadDone(bool ok, void *arg) {
+  Adafruit_MPRLS_Base *self = (Adafruit_MPRLS_Base *)arg;
+  MPRLS_STAT(self->_stats.i2cTransfers++);
+  if (ok) {
+    MPRLS_STAT(self->_stats.i2cBytes += 4);
+    self->_haveData = true;
+  } else {
+    MPRLS_STAT(self->_stats.i2cErrors++);
+  }
+  if (self->_asyncCallback)
+    self->_asyncCallback(ok, self->_asyncArg);
+}
+
+/**************************************************************************/
+/*!
+    @brief Read the EOC line, from the transport if it drives one (e.g. the
+   simulated sensor) and from the pin otherwise
+    @returns True once the conversion is done
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::eocHigh(void) {
+  if (_transport) {
+    int8_t level = _transport->eocLevel();
+    if (level >= 0)
+      return level;
+  }
+  return digitalRead(_eoc);
+}
+
+/**************************************************************************/
+/*!
+    @brief Check whether the conversion started by startConversion() is done.
+   Uses the EOC pin if one was provided, otherwise reads a single status byte
+   (updating lastStatus). In EOC interrupt mode only the flag set by the
+   interrupt is checked, no pin or bus access is made
+    @returns True if the result can be read with fetchResult(). False while
+   converting, and also if the status read failed: the conversion is then
+   abandoned, conversionPending() turns false and lastError() says
+   MPRLS_ERR_I2C
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::isReady(void) {
+  // the command may still be on its way out
+  if (transferPending())
+    return false;
+
+  // The EOC interrupt already told us
+  if (_eocSlot != -1)
+    return _eocFlag;
+
+  // Use the gpio to tell end of conversion
+  if (_eoc != -1) {
+    if (!eocHigh())
+      return false;
+    stampReady();
+    return true;
   }
 
-  // Read status byte and data
-  i2c_dev->read(buffer, 4);
+  // check the status byte. In merged mode the status byte leads the data,
+  // so once it says not busy the data that followed it is the result and
+  // fetchResult() needn't read it again
+  _polls++;
+  if (!busRead(_data, _mergedRead ? 4 : 1)) {
+    // a sensor that stopped answering won't finish, don't wait for the
+    // timeout to say so
+    _converting = false;
+    _lastError = MPRLS_ERR_I2C;
+    recordFailure();
+    return false;
+  }
+  lastStatus = _data[0];
+  if (lastStatus & MPRLS_STATUS_BUSY)
+    return false;
+  _haveData = _mergedRead;
+  stampReady();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Read the result of a completed conversion and check the status
+   byte
+    @returns -1 on failure (check status) or 24 bits of raw ADC reading
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Base::fetchResult(void) {
+  mprls_result_t result;
+  fetchResult(&result);
+  return result.raw;
+}
+
+/**************************************************************************/
+/*!
+    @brief Read the result of a completed conversion, reporting why it
+   failed. Updates lastStatus with the status byte that came with the data
+    @param result Filled in with the reading, error code and status byte
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::fetchResult(mprls_result_t *result) {
+  uint8_t *buffer = _data;
+
+  _converting = false;
+  result->raw = 0xFFFFFFFF;
+  result->status = 0;
+
+  // Read status byte and data, unless a merged poll already did
+  if (_haveData) {
+    _haveData = false;
+  } else if (!busRead(buffer, 4)) {
+    recordFailure();
+    result->error = _lastError = MPRLS_ERR_I2C;
+    return false;
+  }
+  result->status = lastStatus = buffer[0];
 
   // check status byte
   if (buffer[0] & MPRLS_STATUS_MATHSAT) {
-    return 0xFFFFFFFF;
+    MPRLS_STAT(_stats.mathsat++);
+    // out of range is what the high and low alarms are for
+    if (_alarm)
+      _alarm->checkSaturated((uint32_t(buffer[1]) << 16) |
+                             (uint32_t(buffer[2]) << 8) | buffer[3]);
+    result->error = _lastError = MPRLS_ERR_MATHSAT;
+    return false;
   }
   if (buffer[0] & MPRLS_STATUS_FAILED) {
-    return 0xFFFFFFFF;
+    MPRLS_STAT(_stats.failed++);
+    recordFailure();
+    result->error = _lastError = MPRLS_ERR_FAILED;
+    return false;
   }
+  _failures = 0;
+
+#ifdef MPRLS_ENABLE_STATS
+  uint32_t latency = micros() - _convStart;
+  _stats.samples++;
+  _stats.latencyTotal += latency;
+  if (latency < _stats.latencyMin)
+    _stats.latencyMin = latency;
+  if (latency > _stats.latencyMax)
+    _stats.latencyMax = latency;
+  _stats.polls += _polls;
+  if (_polls > _stats.pollsMax)
+    _stats.pollsMax = _polls;
+#endif
 
   // all good, return data
-  return (uint32_t(buffer[1]) << 16) | (uint32_t(buffer[2]) << 8) |
-         (uint32_t(buffer[3]));
+  result->raw = (uint32_t(buffer[1]) << 16) | (uint32_t(buffer[2]) << 8) |
+                (uint32_t(buffer[3]));
+  result->error = _lastError = MPRLS_OK;
+  if (_alarm) {
+    stampReady(); // in case nobody asked isReady()
+    _alarm->check(result->raw, _readyMicros);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Split-phase fetch of a timestamped sample record, call once
+   isReady() returned true
+    @param sample Filled in with the reading, the micros() time the
+   conversion was seen complete (the EOC edge itself in interrupt mode), its
+   sequence number and the status byte
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::fetchSample(mprls_sample_t *sample) {
+  mprls_result_t result;
+  bool ok = fetchResult(&result);
+  fillSample(sample, result);
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Remember when the current conversion was first seen complete
+*/
+/**************************************************************************/
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::stampReady(void) {
+  if (_stamped)
+    return;
+  _readyMicros = micros();
+  _stamped = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Build a sample record for the current conversion
+    @param sample Record to fill
+    @param result What the read returned
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::fillSample(mprls_sample_t *sample,
+                                     const mprls_result_t &result) {
+  stampReady(); // in case nobody asked isReady()
+  sample->raw = result.raw;
+  sample->timestamp = _readyMicros;
+  sample->sequence = _sequence;
+  sample->status = result.status;
 }
 
 /**************************************************************************/
@@ -189,8 +1094,313 @@ uint32_t Adafruit_MPRLS::readData(void) {
     @returns 8 bits of status data
 */
 /**************************************************************************/
-uint8_t Adafruit_MPRLS::readStatus(void) {
-  uint8_t buffer[1];
-  i2c_dev->read(buffer, 1);
+uint8_t Adafruit_MPRLS_Base::readStatus(void) {
+  uint8_t buffer[1] = {0xFF}; // looks busy and not powered if the read fails
+  busRead(buffer, 1);
   return buffer[0];
 }
+
+/**************************************************************************/
+/*!
+    @brief Check whether the conversion in flight has run out of time. If it
+   has, the conversion is abandoned and counted as a failure; call this while
+   isReady() keeps returning false
+    @returns True if the conversion timed out
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::checkTimeout(void) {
+  if (!_converting)
+    return false;
+  if (micros() - _convStart <= _timeout)
+    return false;
+
+  _converting = false;
+  _lastError = MPRLS_ERR_TIMEOUT;
+  MPRLS_STAT(_stats.timeouts++);
+  recordFailure();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set how long a conversion may take before it is given up on
+    @param timeout_us Timeout in microseconds, default is MPRLS_READ_TIMEOUT
+   milliseconds
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setTimeout(uint32_t timeout_us) {
+  _timeout = timeout_us;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set after how many failed reads in a row (timeouts, I2C errors or
+   integrity failures) the sensor is marked unhealthy. While unhealthy, reads
+   fail immediately without starting a conversion; only a single status read
+   every MPRLS_PROBE_INTERVAL_MS checks whether the sensor is back
+    @param failures Consecutive failures, 0 never marks the sensor unhealthy
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setFailureThreshold(uint8_t failures) {
+  _failureThreshold = failures;
+}
+
+/**************************************************************************/
+/*!
+    @brief Check with a single status read whether the sensor is answering
+   and powered again, and if so mark it healthy
+    @returns True if the sensor is healthy
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::probe(void) {
+  lastStatus = readStatus();
+  if ((lastStatus & MPRLS_STATUS_MASK) == MPRLS_STATUS_POWERED) {
+    _healthy = true;
+    _failures = 0;
+  }
+  return _healthy;
+}
+
+/**************************************************************************/
+/*!
+    @brief Count a failed read and mark the sensor unhealthy if there were
+   too many in a row
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::recordFailure(void) {
+  if (_failures < 255)
+    _failures++;
+  if (_healthy && _failureThreshold && _failures >= _failureThreshold) {
+    _healthy = false;
+    _probeTime = millis();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Rate-limited probe() of an unhealthy sensor, a single status read
+   at most every MPRLS_PROBE_INTERVAL_MS. Leaves a startup in progress alone
+    @returns True if the sensor answered and is healthy again
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::retryProbe(void) {
+  if (_powerPhase != MPRLS_POWER_IDLE)
+    return false;
+  uint32_t now = millis();
+  if (now - _probeTime < MPRLS_PROBE_INTERVAL_MS)
+    return false;
+  _probeTime = now;
+  return probe();
+}
+
+/**************************************************************************/
+/*!
+    @brief Configure how readData() waits for a conversion when no EOC pin is
+   used. Each status poll is a full I2C transaction, so the wait starts with
+   a sleep of about the conversion time, then polls at a bounded interval.
+   Use lastPollCount() to tune the values. Passing 0 for both restores back
+   to back polling
+    @param initial_wait_us Time to wait after the command before the first
+   poll, in microseconds
+    @param interval_us Time between further polls, in microseconds
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setPollingStrategy(uint32_t initial_wait_us,
+                                             uint32_t interval_us) {
+  _initialWait = initial_wait_us;
+  _pollInterval = interval_us;
+}
+
+/**************************************************************************/
+/*!
+    @brief In status-polling mode, poll with 4 byte reads instead of reading
+   the status byte alone. The poll that sees the busy bit cleared then
+   already holds the data, saving the separate result read (one address
+   byte plus acks) per sample. Polls that find the sensor busy move 3 more
+   bytes, so this pays off when the wait strategy keeps the number of polls
+   low
+    @param enable True to poll with merged status+data reads
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setMergedRead(bool enable) {
+  _mergedRead = enable;
+  _haveData = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set a function that puts the MCU to sleep. All waits in blocking
+   reads, begin() and reset() then sleep instead of busy-waiting, and in EOC
+   interrupt mode a blocking read sleeps until the EOC edge wakes the MCU
+    @param callback Sleep function, NULL to go back to delay()
+    @param arg Pointer passed through to the callback
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::setSleepCallback(MPRLS_SleepCallback callback,
+                                           void *arg) {
+  _sleep = callback;
+  _sleepArg = arg;
+}
+
+/**************************************************************************/
+/*!
+    @brief Wait, through the sleep callback if one is set, else with delays
+   that cope with more than delayMicroseconds() can handle
+    @param us Time to wait in microseconds
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::idle(uint32_t us) {
+  if (_sleep) {
+    // the MCU may wake early, make sure the full time has passed
+    uint32_t start = micros();
+    uint32_t elapsed;
+    while ((elapsed = micros() - start) < us)
+      _sleep(us - elapsed, _sleepArg);
+    return;
+  }
+
+  if (us >= 1000)
+    delay(us / 1000);
+  if (us % 1000)
+    delayMicroseconds(us % 1000);
+}
+
+/**************************************************************************/
+/*!
+    @brief Attach a hardware interrupt to the EOC pin so that the end of
+   conversion sets a flag instead of having to be polled. isReady() then only
+   checks that flag.
+    @param callback Optional function called from interrupt context when the
+   conversion completes. Keep it short and do not touch the I2C bus from it
+    @param arg Pointer passed through to the callback
+    @returns True on success, False if no EOC pin was given, the pin has no
+   interrupt or all MPRLS_MAX_EOC_INTERRUPTS slots are in use
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::enableEOCInterrupt(MPRLS_EOCCallback callback,
+                                             void *arg) {
+  static void (*const isrs[MPRLS_MAX_EOC_INTERRUPTS])(void) = {
+      eocISR0, eocISR1, eocISR2, eocISR3};
+
+  if (_eoc == -1 || digitalPinToInterrupt(_eoc) == NOT_AN_INTERRUPT)
+    return false;
+  // EOC from the transport has no edge to interrupt on
+  if (_transport && _transport->eocLevel() >= 0)
+    return false;
+
+  disableEOCInterrupt();
+
+  for (uint8_t i = 0; i < MPRLS_MAX_EOC_INTERRUPTS; i++) {
+    if (_eocInstances[i] == NULL) {
+      _eocCallback = callback;
+      _eocArg = arg;
+      // if a conversion already finished we would never see the edge
+      _eocFlag = digitalRead(_eoc);
+      _eocInstances[i] = this;
+      _eocSlot = i;
+      pinMode(_eoc, INPUT);
+      attachInterrupt(digitalPinToInterrupt(_eoc), isrs[i], RISING);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Detach the EOC interrupt and go back to polling the EOC pin
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::disableEOCInterrupt(void) {
+  if (_eocSlot == -1)
+    return;
+
+  detachInterrupt(digitalPinToInterrupt(_eoc));
+  _eocInstances[_eocSlot] = NULL;
+  _eocSlot = -1;
+  _eocCallback = NULL;
+  _eocArg = NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief Interrupt-side handling of the end of conversion
+*/
+/**************************************************************************/
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::handleEOC(void) {
+  stampReady();
+  _eocFlag = true;
+  if (_eocCallback)
+    _eocCallback(_eocArg);
+}
+
+/*! @brief ISR trampoline for EOC interrupt slot 0 */
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::eocISR0(void) {
+  _eocInstances[0]->handleEOC();
+}
+/*! @brief ISR trampoline for EOC interrupt slot 1 */
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::eocISR1(void) {
+  _eocInstances[1]->handleEOC();
+}
+/*! @brief ISR trampoline for EOC interrupt slot 2 */
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::eocISR2(void) {
+  _eocInstances[2]->handleEOC();
+}
+/*! @brief ISR trampoline for EOC interrupt slot 3 */
+MPRLS_ISR_ATTR void Adafruit_MPRLS_Base::eocISR3(void) {
+  _eocInstances[3]->handleEOC();
+}
+
+/**************************************************************************/
+/*!
+    @brief Read from the sensor, all bus reads go through here
+    @param buffer Where to put the data
+    @param len Number of bytes to read
+    @returns True on success
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::busRead(uint8_t *buffer, size_t len) {
+  bool ok = _transport ? _transport->read(buffer, len)
+                       : i2c_dev->read(buffer, len);
+#ifdef MPRLS_ENABLE_STATS
+  _stats.i2cTransfers++;
+  if (ok)
+    _stats.i2cBytes += len;
+  else
+    _stats.i2cErrors++;
+#endif
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Write to the sensor, all bus writes go through here
+    @param buffer The data to send
+    @param len Number of bytes to write
+    @returns True on success
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Base::busWrite(const uint8_t *buffer, size_t len) {
+  bool ok = _transport ? _transport->write(buffer, len)
+                       : i2c_dev->write(buffer, len);
+#ifdef MPRLS_ENABLE_STATS
+  _stats.i2cTransfers++;
+  if (ok)
+    _stats.i2cBytes += len;
+  else
+    _stats.i2cErrors++;
+#endif
+  return ok;
+}
+
+#ifdef MPRLS_ENABLE_STATS
+/**************************************************************************/
+/*!
+    @brief Clear the hot path counters
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Base::resetStats(void) {
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.latencyMin = 0xFFFFFFFF;
+}
+#endif
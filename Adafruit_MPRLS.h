@@ -17,24 +17,289 @@
  *
  */
 
+#ifndef ADAFRUIT_MPRLS_H
+#define ADAFRUIT_MPRLS_H
+
 #if (ARDUINO >= 100)
 #include "Arduino.h"
 #else
 #include "WProgram.h"
 #endif
 
+#include "Adafruit_MPRLS_Transport.h"
 #include <Adafruit_I2CDevice.h>
 
 #define MPRLS_DEFAULT_ADDR (0x18)   ///< Most common I2C address
-#define MPRLS_READ_TIMEOUT (20)     ///< millis
-#define MPRLS_STATUS_POWERED (0x40) ///< Status SPI powered bit
-#define MPRLS_STATUS_BUSY (0x20)    ///< Status busy bit
-#define MPRLS_STATUS_FAILED (0x04)  ///< Status bit for integrity fail
-#define MPRLS_STATUS_MATHSAT (0x01) ///< Status bit for math saturation
-#define COUNTS_224 (16777216L)      ///< Constant: 2^24
-#define PSI_to_HPA (68.947572932)   ///< Constant: PSI to HPA conversion factor
+#define MPRLS_READ_TIMEOUT (20)     ///< millis, default conversion timeout
+#define MPRLS_FAILURE_THRESHOLD                                                \
+  (3) ///< Consecutive failures before a sensor is marked unhealthy
+#define MPRLS_PROBE_INTERVAL_MS                                                \
+  (100) ///< How often an unhealthy sensor is checked on by startConversion()
+#define MPRLS_CONVERSION_TIME_US                                               \
+  (5000) ///< Nominal conversion time, waited before the first status poll
+#define MPRLS_POLL_INTERVAL_US (250) ///< Default time between status polls
+#define MPRLS_RESET_PULSE_MS (10)    ///< How long the reset pin is held low
+#define MPRLS_STARTUP_MS (10)        ///< Time from reset to first status read
+#define MPRLS_STATUS_POWERED (0x40)  ///< Status SPI powered bit
+#define MPRLS_STATUS_BUSY (0x20)     ///< Status busy bit
+#define MPRLS_STATUS_FAILED (0x04)   ///< Status bit for integrity fail
+#define MPRLS_STATUS_MATHSAT (0x01)  ///< Status bit for math saturation
+#define COUNTS_224 (16777216L)       ///< Constant: 2^24
+#define PSI_to_HPA (68.947572932)    ///< Constant: PSI to HPA conversion factor
+#define MPRLS_FIXED_INVALID                                                    \
+  ((int32_t)0x80000000) ///< Fixed point reading returned on failure
+#define MPRLS_MEDIAN_MAX_SAMPLES                                               \
+  (32) ///< Most samples a median oversampled read can hold
 #define MPRLS_STATUS_MASK                                                      \
   (0b01100101) ///< Sensor status mask: only these bits are set
+#define MPRLS_MAX_EOC_INTERRUPTS                                               \
+  (4) ///< How many sensors can use EOC interrupt mode at the same time
+
+#if defined(ESP32) || defined(ESP8266)
+#define MPRLS_ISR_ATTR IRAM_ATTR ///< Keep interrupt handlers in IRAM
+#else
+#define MPRLS_ISR_ATTR ///< No special placement needed for ISRs
+#endif
+
+/** Callback invoked from interrupt context when the EOC pin goes high */
+typedef void (*MPRLS_EOCCallback)(void *arg);
+
+/** Progress of beginAsync() */
+typedef enum {
+  MPRLS_BEGIN_PENDING, ///< Still resetting or starting up
+  MPRLS_BEGIN_OK,      ///< Sensor is powered and ready
+  MPRLS_BEGIN_FAILED,  ///< Sensor did not report powered
+} mprls_begin_t;
+
+/** Why a read failed */
+typedef enum {
+  MPRLS_OK = 0,        ///< Reading is valid
+  MPRLS_ERR_TIMEOUT,   ///< Conversion did not complete in time
+  MPRLS_ERR_MATHSAT,   ///< Sensor reported math saturation
+  MPRLS_ERR_FAILED,    ///< Sensor reported an integrity failure
+  MPRLS_ERR_I2C,       ///< The sensor did not acknowledge a transfer
+  MPRLS_ERR_UNHEALTHY, ///< Not attempted, the sensor is marked unhealthy
+} mprls_error_t;
+
+/** Outcome of a single read, everything learned from one transaction */
+typedef struct {
+  uint32_t raw;        ///< 24 bits of raw ADC reading, 0xFFFFFFFF on error
+  mprls_error_t error; ///< MPRLS_OK or why the read failed
+  uint8_t status;      ///< Status byte that came with the reading
+} mprls_result_t;
+
+/** How oversampled reads combine their samples */
+typedef enum {
+  MPRLS_AVERAGE_MEAN,    ///< Plain mean of all samples
+  MPRLS_AVERAGE_TRIMMED, ///< Mean without the highest and lowest sample
+  MPRLS_AVERAGE_MEDIAN,  ///< Median, up to MPRLS_MEDIAN_MAX_SAMPLES samples
+} mprls_average_t;
+
+/** Callback that lets the MCU sleep for up to us microseconds, it may return
+ * early when an interrupt (e.g. the EOC pin) wakes the MCU */
+typedef void (*MPRLS_SleepCallback)(uint32_t us, void *arg);
+
+/** A single raw measurement with the time it completed */
+typedef struct {
+  uint32_t raw;       ///< 24 bits of raw ADC reading
+  uint32_t timestamp; ///< micros() at the EOC edge or ready status
+  uint16_t sequence;  ///< Conversion number, gaps mean failed conversions
+  uint8_t status;     ///< Status byte that came with the reading
+} mprls_sample_t;
+
+#ifdef MPRLS_ENABLE_STATS
+/** Hot path counters, only available when the whole build (not just the
+ * sketch, it changes the class layout) defines MPRLS_ENABLE_STATS */
+typedef struct {
+  uint32_t samples;      ///< Conversions read successfully
+  uint32_t latencyMin;   ///< Shortest command to result time, us
+  uint32_t latencyMax;   ///< Longest command to result time, us
+  uint64_t latencyTotal; ///< Sum of all latencies, divide by samples
+  uint32_t polls;        ///< Status polls over all samples
+  uint16_t pollsMax;     ///< Most status polls for a single sample
+  uint32_t timeouts;     ///< Conversions that timed out
+  uint32_t mathsat;      ///< Results rejected for math saturation
+  uint32_t failed;       ///< Results rejected for integrity failure
+  uint32_t i2cErrors;    ///< I2C transactions that failed
+  uint32_t i2cBytes;     ///< Bytes moved over I2C successfully
+  uint32_t i2cTransfers; ///< I2C transactions attempted
+} mprls_stats_t;
+#define MPRLS_STAT(x)                                                          \
+  do {                                                                         \
+    x;                                                                         \
+  } while (0) ///< Update the stats
+#else
+#define MPRLS_STAT(x)                                                          \
+  do {                                                                         \
+  } while (0) ///< Stats disabled, compiles to nothing
+#endif
+
+class Adafruit_MPRLS_Alarm;
+
+/**************************************************************************/
+/*!
+    @brief  Everything about an MPRLS sensor except turning counts into
+   pressure: the bus, startup, the split-phase and blocking raw reads, EOC,
+   timeouts and health. Adafruit_MPRLS adds the runtime transfer function on
+   top, Adafruit_MPRLS_T a compile-time one that takes no RAM
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Base {
+public:
+  Adafruit_MPRLS_Base(int8_t reset_pin = -1, int8_t EOC_pin = -1);
+  ~Adafruit_MPRLS_Base(void);
+
+  bool begin(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR, TwoWire *twoWire = &Wire);
+  bool reset(void);
+  bool beginAsync(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR,
+                  TwoWire *twoWire = &Wire);
+  bool resetAsync(void);
+  mprls_begin_t pollBegin(void);
+
+  uint8_t readStatus(void);
+  uint32_t readData(void);
+  mprls_result_t readResult(void);
+  uint32_t readRawOversampled(uint8_t samples,
+                              mprls_average_t mode = MPRLS_AVERAGE_MEAN);
+  /*! @brief Why the last read failed @returns MPRLS_OK if it did not */
+  mprls_error_t lastError(void) { return _lastError; }
+
+  bool startConversion(void);
+  bool isReady(void);
+  uint32_t fetchResult(void);
+  bool fetchResult(mprls_result_t *result);
+  bool fetchSample(mprls_sample_t *sample);
+  bool readSample(mprls_sample_t *sample);
+
+  void setTransport(Adafruit_MPRLS_Transport *transport);
+  /*! @brief Check every successful (or math saturated) read against a set
+   * of alarms
+   * @param alarm The alarms, NULL for none */
+  void setAlarm(Adafruit_MPRLS_Alarm *alarm) { _alarm = alarm; }
+  bool startConversionAsync(void);
+  bool fetchResultAsync(MPRLS_TransferCallback callback = NULL,
+                        void *arg = NULL);
+  /*! @brief Check for a background transfer in flight
+   * @returns True until the transport has finished */
+  bool transferPending(void) { return _transport && _transport->busy(); }
+
+  /*! @brief Check for a conversion started but not read yet
+   * @returns True while a conversion is in flight */
+  bool conversionPending(void) { return _converting; }
+  bool checkTimeout(void);
+  void setTimeout(uint32_t timeout_us);
+  /*! @brief How long a conversion may take before it is abandoned
+   * @returns Timeout in microseconds, see setTimeout() */
+  uint32_t timeout(void) { return _timeout; }
+  void setFailureThreshold(uint8_t failures);
+  /*! @brief Check whether reads are being attempted at all
+   * @returns False once the failure threshold was hit, until probe() or
+   * begin() succeed. startConversion() probes by itself every
+   * MPRLS_PROBE_INTERVAL_MS */
+  bool isHealthy(void) { return _healthy; }
+  bool probe(void);
+
+  void setPollingStrategy(uint32_t initial_wait_us = MPRLS_CONVERSION_TIME_US,
+                          uint32_t interval_us = MPRLS_POLL_INTERVAL_US);
+  /*! @brief Number of status polls made for the last conversion
+   * @returns Poll count, always 0 when an EOC pin is used */
+  uint16_t lastPollCount(void) { return _polls; }
+  void setMergedRead(bool enable);
+
+  void setSleepCallback(MPRLS_SleepCallback callback, void *arg = NULL);
+  void idle(uint32_t us);
+
+  bool enableEOCInterrupt(MPRLS_EOCCallback callback = NULL, void *arg = NULL);
+  void disableEOCInterrupt(void);
+
+#ifdef MPRLS_ENABLE_STATS
+  /*! @brief Hot path counters since begin() or resetStats()
+   * @returns The counters */
+  const mprls_stats_t &getStats(void) { return _stats; }
+  void resetStats(void);
+#endif
+
+  uint8_t lastStatus; /*!< status byte after last operation */
+
+protected:
+  uint8_t oversample(uint8_t samples, mprls_average_t mode, uint32_t *sum);
+
+private:
+  friend class Adafruit_MPRLS_Pressure;
+  friend class Adafruit_MPRLS_Manager;
+  friend class Adafruit_MPRLS_Continuous;
+  friend class Adafruit_MPRLS_RTOS;
+
+  Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
+  Adafruit_I2CDevice _i2c_device;     ///< Storage for i2c_dev, no heap used
+  bool busRead(uint8_t *buffer, size_t len);
+  bool busWrite(const uint8_t *buffer, size_t len);
+  mprls_result_t finishConversion(void);
+  uint32_t capWait(uint32_t us);
+
+  Adafruit_MPRLS_Transport *_transport = NULL;  ///< Replaces i2c_dev if set
+  Adafruit_MPRLS_Alarm *_alarm = NULL;          ///< Checked on every read
+  MPRLS_TransferCallback _asyncCallback = NULL; ///< User fetch callback
+  void *_asyncArg = NULL;                       ///< Argument for it
+  bool prepareConversion(void);
+  bool fetchRaw(void);
+  static void asyncWriteDone(bool ok, void *arg);
+  static void asyncReadDone(bool ok, void *arg);
+
+#ifdef MPRLS_ENABLE_STATS
+  mprls_stats_t _stats; ///< Hot path counters
+#endif
+
+  int8_t _reset, _eoc;
+
+  /// Conversion timeout in microseconds
+  uint32_t _timeout = MPRLS_READ_TIMEOUT * 1000UL;
+  /// Consecutive failures after which the sensor is marked unhealthy
+  uint8_t _failureThreshold = MPRLS_FAILURE_THRESHOLD;
+  uint32_t _convStart = 0;             ///< micros() at conversion start
+  bool _converting = false;            ///< A conversion is in flight
+  bool _healthy = true;                ///< False after too many failures
+  uint32_t _probeTime = 0;             ///< millis() of the last check on it
+  uint8_t _failures = 0;               ///< Consecutive failed reads
+  mprls_error_t _lastError = MPRLS_OK; ///< Outcome of the last read
+  void recordFailure(void);
+  bool retryProbe(void);
+
+  uint32_t _initialWait = MPRLS_CONVERSION_TIME_US; ///< us before first poll
+  uint32_t _pollInterval = MPRLS_POLL_INTERVAL_US;  ///< us between polls
+  uint16_t _polls = 0;                              ///< Polls this conversion
+
+  bool _mergedRead = false;          ///< Poll with full 4 byte reads
+  volatile bool _haveData = false;   ///< _data holds the finished conversion
+  uint8_t _data[4];                  ///< Result captured by a merged poll
+  MPRLS_SleepCallback _sleep = NULL; ///< Optional low power wait
+  void *_sleepArg = NULL;            ///< Argument for the sleep callback
+  bool powerUp(void);
+
+  uint8_t _powerPhase = 0;  ///< Where the startup sequence is at
+  uint32_t _powerStart = 0; ///< micros() the current phase started
+  uint32_t _powerWait = 0;  ///< How long the current phase lasts, us
+  bool setupBus(uint8_t i2c_addr, TwoWire *twoWire);
+
+  volatile uint32_t _readyMicros = 0; ///< When the conversion completed
+  volatile bool _stamped = false;     ///< _readyMicros is for this one
+  uint16_t _sequence = 0;             ///< Number of the current conversion
+  void stampReady(void);
+  bool eocHigh(void);
+  void fillSample(mprls_sample_t *sample, const mprls_result_t &result);
+
+  volatile bool _eocFlag = false;        ///< Set by the EOC interrupt
+  int8_t _eocSlot = -1;                  ///< Interrupt slot, -1 if polling
+  MPRLS_EOCCallback _eocCallback = NULL; ///< Optional user EOC callback
+  void *_eocArg = NULL;                  ///< Argument for the EOC callback
+
+  void handleEOC(void);
+  static Adafruit_MPRLS_Base *_eocInstances[MPRLS_MAX_EOC_INTERRUPTS];
+  static void eocISR0(void);
+  static void eocISR1(void);
+  static void eocISR2(void);
+  static void eocISR3(void);
+};
 
 /**************************************************************************/
 /*!
@@ -42,26 +307,107 @@
    sensor IC
 */
 /**************************************************************************/
-class Adafruit_MPRLS {
+class Adafruit_MPRLS : public Adafruit_MPRLS_Base {
 public:
   Adafruit_MPRLS(int8_t reset_pin = -1, int8_t EOC_pin = -1,
                  uint16_t PSI_min = 0, uint16_t PSI_max = 25,
                  float OUTPUT_min = 10, float OUTPUT_max = 90,
                  float K = PSI_to_HPA);
 
-  bool begin(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR, TwoWire *twoWire = &Wire);
+  bool setTransferFunction(float PSI_min, float PSI_max, float OUTPUT_min = 10,
+                           float OUTPUT_max = 90);
+  void setUnits(float K);
+  bool setProfile(const char *partNumber);
 
-  uint8_t readStatus(void);
   float readPressure(void);
-
-  uint8_t lastStatus; /*!< status byte after last operation */
+  float convertRaw(uint32_t raw);
+  void convertRaw(const uint32_t *raw, float *pressure, size_t count);
+  int32_t readPressureFixed(void);
+  int32_t convertRawFixed(uint32_t raw);
+  void convertRawFixed(const uint32_t *raw, int32_t *pressure, size_t count);
+  float readPressureAveraged(uint8_t samples,
+                             mprls_average_t mode = MPRLS_AVERAGE_MEAN);
 
 private:
-  Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
-  uint32_t readData(void);
+  friend class Adafruit_MPRLS_Pressure;
+  friend class Adafruit_MPRLS_Alarm;
 
-  int8_t _reset, _eoc;
-  uint16_t _PSI_min, _PSI_max;
+  float _PSI_min, _PSI_max; ///< Signed, so compound ranges like +-15 work
   uint32_t _OUTPUT_min, _OUTPUT_max;
   float _K;
+
+  float _gain = NAN;        ///< Units per count, NAN if unusable
+  float _offset = 0;        ///< Units at zero counts
+  int32_t _fixedGain = 0;   ///< Q16.16 units per count << 24
+  int32_t _fixedOffset = 0; ///< Units at zero counts, Q16.16
+  void computeCoefficients(void);
+};
+
+/**************************************************************************/
+/*!
+    @brief  MPRLS sensor whose transfer function is known at compile time,
+   reporting hPa. The conversion coefficients are constexpr so the compiler
+   folds readPressure()/convertRaw() down to immediates, and as it builds on
+   Adafruit_MPRLS_Base there are no curve members taking RAM either. Works
+   with everything that takes raw counts (the manager, the acquisition
+   engine, recovery, duty cycling); the helpers that convert to units in
+   place need an Adafruit_MPRLS
+    @tparam PSI_MIN The minimum PSI measurement range of the sensor
+    @tparam PSI_MAX The maximum PSI measurement range of the sensor
+    @tparam OUT_MIN_PCT The minimum transfer function curve value in %
+    @tparam OUT_MAX_PCT The maximum transfer function curve value in %
+*/
+/**************************************************************************/
+template <uint16_t PSI_MIN, uint16_t PSI_MAX, uint8_t OUT_MIN_PCT = 10,
+          uint8_t OUT_MAX_PCT = 90>
+class Adafruit_MPRLS_T : public Adafruit_MPRLS_Base {
+  static_assert(PSI_MAX > PSI_MIN, "PSI_MAX must be above PSI_MIN");
+  static_assert(OUT_MAX_PCT > OUT_MIN_PCT && OUT_MAX_PCT <= 100,
+                "Output curve must be increasing and within 0-100%");
+
+public:
+  /*!
+      @brief constructor, only the pins are configurable at runtime
+      @param reset_pin Optional hardware reset pin, -1 to skip
+      @param EOC_pin Optional End-of-Convert indication pin, -1 to skip
+  */
+  Adafruit_MPRLS_T(int8_t reset_pin = -1, int8_t EOC_pin = -1)
+      : Adafruit_MPRLS_Base(reset_pin, EOC_pin) {}
+
+  /*! @brief Counts at the bottom of the transfer function @returns Counts */
+  static constexpr uint32_t outputMin(void) {
+    return (uint32_t)((float)COUNTS_224 * (OUT_MIN_PCT / 100.0) + 0.5);
+  }
+  /*! @brief Counts at the top of the transfer function @returns Counts */
+  static constexpr uint32_t outputMax(void) {
+    return (uint32_t)((float)COUNTS_224 * (OUT_MAX_PCT / 100.0) + 0.5);
+  }
+  /*! @brief hPa per count @returns The conversion gain */
+  static constexpr float gain(void) {
+    return (float)(((double)PSI_MAX - PSI_MIN) * PSI_to_HPA /
+                   ((double)outputMax() - (double)outputMin()));
+  }
+  /*! @brief hPa at zero counts @returns The conversion offset */
+  static constexpr float offset(void) {
+    return (float)((double)PSI_MIN * PSI_to_HPA -
+                   (double)outputMin() * ((double)PSI_MAX - PSI_MIN) *
+                       PSI_to_HPA / ((double)outputMax() - outputMin()));
+  }
+
+  /*!
+      @brief Convert a raw reading with the compile-time coefficients
+      @param raw 24 bits of raw ADC reading
+      @returns The pressure in hPa, NAN if raw is 0xFFFFFFFF
+  */
+  static float convertRaw(uint32_t raw) {
+    return (raw == 0xFFFFFFFF) ? NAN : (float)raw * gain() + offset();
+  }
+
+  /*!
+      @brief Read and calculate the pressure
+      @returns The measured pressure, in hPa on success, NAN on failure
+  */
+  float readPressure(void) { return convertRaw(readData()); }
 };
+
+#endif
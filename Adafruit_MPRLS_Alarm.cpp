@@ -0,0 +1,224 @@
+/*!
+ * @file Adafruit_MPRLS_Alarm.cpp
+ *
+ * Pressure limit alarms for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Alarm.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param sensor The sensor whose units and transfer function the limits
+   are given in
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Alarm::Adafruit_MPRLS_Alarm(Adafruit_MPRLS *sensor) {
+  _sensor = sensor;
+}
+
+/**************************************************************************/
+/*!
+    @brief Raise MPRLS_ALARM_HIGH above a limit
+    @param limit Pressure in the sensor's units
+    @param hysteresis How far below the limit the pressure has to fall before
+   the alarm clears
+    @returns False if the sensor's transfer function is unusable
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Alarm::setHigh(float limit, float hysteresis) {
+  _high = limit;
+  _highHyst = fabs(hysteresis);
+  _enabled |= MPRLS_ALARM_HIGH;
+  return update();
+}
+
+/**************************************************************************/
+/*!
+    @brief Raise MPRLS_ALARM_LOW below a limit
+    @param limit Pressure in the sensor's units
+    @param hysteresis How far above the limit the pressure has to rise before
+   the alarm clears
+    @returns False if the sensor's transfer function is unusable
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Alarm::setLow(float limit, float hysteresis) {
+  _low = limit;
+  _lowHyst = fabs(hysteresis);
+  _enabled |= MPRLS_ALARM_LOW;
+  return update();
+}
+
+/**************************************************************************/
+/*!
+    @brief Raise MPRLS_ALARM_RATE while the pressure changes faster than a
+   limit, in either direction
+    @param limit Change in the sensor's units per second
+    @returns False if the sensor's transfer function is unusable
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Alarm::setRate(float limit) {
+  _rate = fabs(limit);
+  _enabled |= MPRLS_ALARM_RATE;
+  _haveLast = false;
+  return update();
+}
+
+/**************************************************************************/
+/*!
+    @brief Stop checking some alarms, clearing them if raised
+    @param alarms MPRLS_ALARM_* bits
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Alarm::disable(uint8_t alarms) {
+  _enabled &= ~alarms;
+  _active &= ~alarms;
+}
+
+/**************************************************************************/
+/*!
+    @brief Convert the limits to counts again, call after changing the
+   sensor's transfer function or units
+    @returns False if the sensor's transfer function is unusable
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Alarm::update(void) {
+  float gain = _sensor->_gain;
+  if (isnan(gain) || gain <= 0)
+    return false;
+
+  _highOn = toCounts(_high);
+  _highOff = toCounts(_high - _highHyst);
+  _lowOn = toCounts(_low);
+  _lowOff = toCounts(_low + _lowHyst);
+  float rate = _rate / gain + 0.5;
+  _rateCounts = rate < 4294967295.0 ? (uint32_t)rate : 0xFFFFFFFF;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Get told when alarms are raised or cleared
+    @param callback Called with the raised MPRLS_ALARM_* bits and the raw
+   reading whenever they change, NULL for none. Runs wherever the sensor's
+   result is fetched, which can be an interrupt-free but tight loop
+    @param arg Pointer passed through to the callback
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Alarm::setCallback(MPRLS_AlarmCallback callback,
+                                       void *arg) {
+  _callback = callback;
+  _arg = arg;
+}
+
+/**************************************************************************/
+/*!
+    @brief Check a reading against the limits, integer compares only (the
+   rate check needs one 64 bit multiply per side)
+    @param raw 24 bit raw reading
+    @param timestamp micros() when the reading completed
+    @returns The MPRLS_ALARM_* bits raised after this reading
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Alarm::check(uint32_t raw, uint32_t timestamp) {
+  uint8_t active = checkLimits(raw);
+
+  if (_enabled & MPRLS_ALARM_RATE) {
+    uint32_t dt = timestamp - _lastTime;
+    if (_haveLast && dt) {
+      uint32_t delta = raw > _lastRaw ? raw - _lastRaw : _lastRaw - raw;
+      // delta / dt > counts per second / 1e6, without dividing
+      if ((uint64_t)delta * 1000000UL > (uint64_t)_rateCounts * dt)
+        active |= MPRLS_ALARM_RATE;
+      else
+        active &= ~MPRLS_ALARM_RATE;
+    }
+    _lastRaw = raw;
+    _lastTime = timestamp;
+    _haveLast = true;
+  }
+
+  report(active, raw);
+  return active;
+}
+
+/**************************************************************************/
+/*!
+    @brief Check a reading the sensor flagged with math saturation. The
+   pressure is off the end of the sensor's range, which is exactly what the
+   high and low alarms must catch, so the counts are taken as pinned to the
+   end of the range they are on. The rate alarm is left alone, the jump to
+   the end isn't a real change
+    @param raw 24 bit raw reading that came with the saturated status
+    @returns The MPRLS_ALARM_* bits raised after this reading
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Alarm::checkSaturated(uint32_t raw) {
+  uint8_t active = checkLimits(raw & 0x800000 ? 0xFFFFFF : 0);
+  report(active, raw);
+  return active;
+}
+
+/**************************************************************************/
+/*!
+    @brief Run the high and low alarms' hysteresis on a reading
+    @param raw 24 bit raw reading
+    @returns The raised MPRLS_ALARM_* bits with the high and low ones updated
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Alarm::checkLimits(uint32_t raw) {
+  uint8_t active = _active;
+
+  if (_enabled & MPRLS_ALARM_HIGH) {
+    if (raw > _highOn)
+      active |= MPRLS_ALARM_HIGH;
+    else if (raw < _highOff)
+      active &= ~MPRLS_ALARM_HIGH;
+  }
+  if (_enabled & MPRLS_ALARM_LOW) {
+    if (raw < _lowOn)
+      active |= MPRLS_ALARM_LOW;
+    else if (raw > _lowOff)
+      active &= ~MPRLS_ALARM_LOW;
+  }
+  return active;
+}
+
+/**************************************************************************/
+/*!
+    @brief Store the raised alarms and tell the callback if they changed
+    @param active The MPRLS_ALARM_* bits now raised
+    @param raw The reading that raised them
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Alarm::report(uint8_t active, uint32_t raw) {
+  if (active != _active) {
+    _active = active;
+    if (_callback)
+      _callback(active, raw, _arg);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Turn a pressure into the raw reading it would give
+    @param value Pressure in the sensor's units
+    @returns Counts, clamped to 24 bits
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Alarm::toCounts(float value) {
+  float counts = (value - _sensor->_offset) / _sensor->_gain + 0.5;
+  if (counts <= 0)
+    return 0;
+  if (counts >= 0xFFFFFF)
+    return 0xFFFFFF;
+  return (uint32_t)counts;
+}
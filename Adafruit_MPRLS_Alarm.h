@@ -0,0 +1,82 @@
+/*!
+ * @file Adafruit_MPRLS_Alarm.h
+ *
+ * Pressure limit alarms for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_ALARM_H
+#define ADAFRUIT_MPRLS_ALARM_H
+
+#include "Adafruit_MPRLS.h"
+
+#define MPRLS_ALARM_HIGH (0x01) ///< Pressure is above the high limit
+#define MPRLS_ALARM_LOW (0x02)  ///< Pressure is below the low limit
+#define MPRLS_ALARM_RATE (0x04) ///< Pressure changes faster than the limit
+
+/** Called when the set of raised alarms changes, from the sensor's fetch */
+typedef void (*MPRLS_AlarmCallback)(uint8_t alarms, uint32_t raw, void *arg);
+
+/**************************************************************************/
+/*!
+    @brief  High, low and rate-of-change alarms with hysteresis. Limits are
+   given in the sensor's units and turned into raw count thresholds once, so
+   checking a sample is a few integer compares. Attached with
+   Adafruit_MPRLS::setAlarm() every successful read is checked as soon as its
+   bytes are in, before any conversion to float. So are reads the sensor
+   flagged with math saturation, taken as beyond the end of the range they
+   are on
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Alarm {
+public:
+  Adafruit_MPRLS_Alarm(Adafruit_MPRLS *sensor);
+
+  bool setHigh(float limit, float hysteresis = 0);
+  bool setLow(float limit, float hysteresis = 0);
+  bool setRate(float limit);
+  void disable(uint8_t alarms);
+  bool update(void);
+
+  void setCallback(MPRLS_AlarmCallback callback, void *arg = NULL);
+  /*! @brief Alarms currently raised @returns MPRLS_ALARM_* bits */
+  uint8_t active(void) { return _active; }
+
+  uint8_t check(uint32_t raw, uint32_t timestamp);
+  uint8_t checkSaturated(uint32_t raw);
+
+private:
+  Adafruit_MPRLS *_sensor;
+  uint8_t _enabled = 0;
+  volatile uint8_t _active = 0;
+
+  // limits in the sensor's units, kept for update()
+  float _high = 0, _highHyst = 0;
+  float _low = 0, _lowHyst = 0;
+  float _rate = 0;
+
+  // the same in counts
+  uint32_t _highOn = 0, _highOff = 0;
+  uint32_t _lowOn = 0, _lowOff = 0;
+  uint32_t _rateCounts = 0; ///< Counts per second
+
+  uint32_t _lastRaw = 0;
+  uint32_t _lastTime = 0;
+  bool _haveLast = false;
+
+  MPRLS_AlarmCallback _callback = NULL;
+  void *_arg = NULL;
+
+  uint32_t toCounts(float value);
+  uint8_t checkLimits(uint32_t raw);
+  void report(uint8_t active, uint32_t raw);
+};
+
+#endif
@@ -0,0 +1,386 @@
+/*!
+ * @file Adafruit_MPRLS_Continuous.cpp
+ *
+ * Free-running acquisition for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Continuous.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor for a queue on top of caller-provided storage
+    @param buffer Array of samples used as the ring storage
+    @param size Number of elements in buffer, at least 2
+*/
+/**************************************************************************/
+Adafruit_MPRLS_SampleQueue::Adafruit_MPRLS_SampleQueue(mprls_sample_t *buffer,
+                                                       mprls_index_t size) {
+  _buffer = buffer;
+  _size = size;
+}
+
+/**************************************************************************/
+/*!
+    @brief Add a sample, producer side only. Never blocks
+    @param sample The sample to copy into the queue
+    @returns True on success, False if the queue was full
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_SampleQueue::push(const mprls_sample_t &sample) {
+  return push(&sample, 1) == 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief Add a block of samples and publish them together, producer side
+   only. Never blocks
+    @param samples The samples to copy into the queue
+    @param count Number of samples
+    @returns The number of samples queued, less than count if it got full
+*/
+/**************************************************************************/
+mprls_index_t Adafruit_MPRLS_SampleQueue::push(const mprls_sample_t *samples,
+                                               mprls_index_t count) {
+  mprls_index_t head = _head;
+  mprls_index_t tail = MPRLS_LOAD_ACQUIRE(_tail);
+  mprls_index_t n = 0;
+
+  while (n < count) {
+    mprls_index_t next = head + 1;
+    if (next == _size)
+      next = 0;
+    if (next == tail)
+      break; // full
+    _buffer[head] = samples[n++];
+    head = next;
+  }
+  MPRLS_STORE_RELEASE(_head, head); // publish only once the slots are written
+  return n;
+}
+
+/**************************************************************************/
+/*!
+    @brief Remove the oldest sample, consumer side only
+    @param sample Where to copy the sample
+    @returns True on success, False if the queue was empty
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_SampleQueue::pop(mprls_sample_t *sample) {
+  return pop(sample, 1) == 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief Drain up to max samples in one go, consumer side only
+    @param samples Array to copy the samples into
+    @param max Size of the samples array
+    @returns The number of samples copied
+*/
+/**************************************************************************/
+mprls_index_t Adafruit_MPRLS_SampleQueue::pop(mprls_sample_t *samples,
+                                              mprls_index_t max) {
+  mprls_index_t tail = _tail;
+  // snapshot, later pushes are picked up next time
+  mprls_index_t head = MPRLS_LOAD_ACQUIRE(_head);
+  mprls_index_t n = 0;
+
+  while (tail != head && n < max) {
+    samples[n++] = _buffer[tail];
+    if (++tail == _size)
+      tail = 0;
+  }
+  MPRLS_STORE_RELEASE(_tail, tail); // hand the slots back once copied out
+  return n;
+}
+
+/**************************************************************************/
+/*!
+    @brief How many samples are waiting to be read
+    @returns The number of queued samples
+*/
+/**************************************************************************/
+mprls_index_t Adafruit_MPRLS_SampleQueue::available(void) {
+  mprls_index_t head = MPRLS_LOAD_ACQUIRE(_head);
+  mprls_index_t tail = MPRLS_LOAD_ACQUIRE(_tail);
+  if (head >= tail)
+    return head - tail;
+  return _size - tail + head;
+}
+
+/**************************************************************************/
+/*!
+    @brief Throw away all queued samples, consumer side only
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_SampleQueue::clear(void) {
+  MPRLS_STORE_RELEASE(_tail, MPRLS_LOAD_ACQUIRE(_head));
+}
+
+/**************************************************************************/
+/*!
+    @brief constructor for the acquisition engine
+    @param sensor The sensor to sample, begin() must have succeeded before
+   start() is called
+    @param queue Where to push the samples
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Continuous::Adafruit_MPRLS_Continuous(
+    Adafruit_MPRLS_Base *sensor, Adafruit_MPRLS_SampleQueue *queue) {
+  _sensor = sensor;
+  _queue = queue;
+}
+
+/**************************************************************************/
+/*!
+    @brief Start acquiring, the first conversion is triggered immediately
+    @param interval_us Time between conversion starts in microseconds, 0 to
+   re-trigger as soon as the previous conversion has been read
+    @returns True if the first conversion could be started
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Continuous::start(uint32_t interval_us) {
+  _interval = _baseInterval = interval_us;
+  _haveReference = false;
+  _running = true;
+  _converting = false;
+  _lastTrigger = micros() - interval_us; // so the schedule starts now
+  trigger(_lastTrigger + interval_us);
+  return _converting;
+}
+
+/**************************************************************************/
+/*!
+    @brief Stop acquiring. A conversion in flight is simply abandoned
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::stop(void) {
+  _running = false;
+  _converting = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Producer step, call as often as possible from loop() or a task.
+   It only ever does a single short I2C transaction per step so it never
+   waits for a conversion, and it only polls the status once the sensor's
+   initial wait, and after that its poll interval, has passed (see
+   Adafruit_MPRLS::setPollingStrategy()), so calling it in a tight loop
+   doesn't flood the bus. With the sensor in EOC interrupt mode a step
+   without a finished conversion makes no bus access at all
+    @returns True if a new sample was pushed into the queue, or with block
+   handoff (see setBlock()) a full block
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Continuous::service(void) {
+  if (!_running)
+    return false;
+
+  bool pushed = false;
+  uint32_t now = micros();
+
+  if (_converting) {
+    if ((int32_t)(now - _nextPoll) < 0)
+      return false; // not due yet
+
+    if (_sensor->isReady()) {
+      mprls_sample_t sample;
+      bool ok = _sensor->fetchSample(&sample);
+      _converting = false;
+
+      if (!ok) {
+        _errors++;
+      } else {
+        if (_filter)
+          sample.raw = _filter->process(sample.raw);
+        pushed = queueSample(sample);
+        adapt(sample);
+      }
+      now = micros();
+    } else if (!_sensor->conversionPending() || _sensor->checkTimeout()) {
+      _errors++; // try again
+      _converting = false;
+    } else {
+      schedulePoll(false);
+      return false;
+    }
+  }
+
+  // an unhealthy sensor fails at once, so retry it no faster than
+  // startConversion() would probe it
+  uint32_t interval = _interval;
+  if (!_sensor->isHealthy() && interval < MPRLS_PROBE_INTERVAL_MS * 1000UL)
+    interval = MPRLS_PROBE_INTERVAL_MS * 1000UL;
+  if (interval == 0 || now - _lastTrigger >= interval)
+    trigger(now);
+
+  return pushed;
+}
+
+/**************************************************************************/
+/*!
+    @brief Let the sampling interval follow the signal. While consecutive
+   samples differ by no more than the deadband the interval doubles, up to
+   max_interval_us. Once a sample is threshold counts away from the one that
+   last crossed it, the engine drops back to the interval given to start()
+    @param max_interval_us Longest interval, 0 to turn adapting off
+    @param deadband Largest sample to sample change, in counts, still
+   considered flat
+    @param threshold Change in counts that counts as significant, 0 for none
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::setAdaptive(uint32_t max_interval_us,
+                                            uint32_t deadband,
+                                            uint32_t threshold) {
+  _maxInterval = max_interval_us;
+  _deadband = deadband;
+  _threshold = threshold;
+  if (!_maxInterval)
+    _interval = _baseInterval;
+}
+
+/**************************************************************************/
+/*!
+    @brief Get told about significant changes only, see setAdaptive(). Works
+   with a threshold set even when the interval doesn't adapt
+    @param callback Called from service() with the sample that crossed the
+   threshold, NULL for none
+    @param arg Pointer passed through to the callback
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::setChangeCallback(
+    MPRLS_ChangeCallback callback, void *arg) {
+  _changeCallback = callback;
+  _changeArg = arg;
+}
+
+/**************************************************************************/
+/*!
+    @brief Update the interval and report significant changes
+    @param sample The sample just taken
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::adapt(const mprls_sample_t &sample) {
+  uint32_t raw = sample.raw;
+  if (!_haveReference) {
+    _previous = _reference = raw;
+    _haveReference = true;
+    return;
+  }
+
+  uint32_t step = raw > _previous ? raw - _previous : _previous - raw;
+  uint32_t change = raw > _reference ? raw - _reference : _reference - raw;
+  _previous = raw;
+
+  if (_threshold && change >= _threshold) {
+    _reference = raw;
+    if (_maxInterval)
+      _interval = _baseInterval;
+    if (_changeCallback)
+      _changeCallback(&sample, _changeArg);
+    return;
+  }
+
+  if (_maxInterval && step <= _deadband && _interval < _maxInterval) {
+    uint32_t next = _interval * 2;
+    if (next < MPRLS_CONVERSION_TIME_US)
+      next = MPRLS_CONVERSION_TIME_US;
+    _interval = next < _maxInterval ? next : _maxInterval;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Collect samples into blocks and hand each full block to the queue
+   in one go. With a consumer on another core this means one index update,
+   and one cache line bouncing between the cores, per block instead of per
+   sample
+    @param block Staging array owned by the engine from now on, NULL to go
+   back to queueing every sample on its own
+    @param size Number of elements in block
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::setBlock(mprls_sample_t *block,
+                                         mprls_index_t size) {
+  _block = size ? block : NULL;
+  _blockSize = _block ? size : 0;
+  _blockFill = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Hand a partly filled block to the queue now, producer side only
+    @returns True if any samples were queued
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Continuous::flush(void) {
+  if (!_blockFill)
+    return false;
+  mprls_index_t n = _queue->push(_block, _blockFill);
+  _dropped += _blockFill - n;
+  _blockFill = 0;
+  return n != 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Queue a sample, or stage it when block handoff is on
+    @param sample The sample
+    @returns True if samples were handed to the queue
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Continuous::queueSample(const mprls_sample_t &sample) {
+  if (!_block) {
+    if (_queue->push(sample))
+      return true;
+    _dropped++;
+    return false;
+  }
+
+  _block[_blockFill++] = sample;
+  if (_blockFill < _blockSize)
+    return false;
+  return flush();
+}
+
+/**************************************************************************/
+/*!
+    @brief Start the next conversion and advance the schedule
+    @param now Current micros()
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::trigger(uint32_t now) {
+  // stay on the fixed grid unless we fell more than one interval behind
+  if (_interval != 0 && now - _lastTrigger < 2 * _interval)
+    _lastTrigger += _interval;
+  else
+    _lastTrigger = now;
+
+  _converting = _sensor->startConversion();
+  if (_converting)
+    schedulePoll(true);
+  else if (_sensor->lastError() != MPRLS_ERR_UNHEALTHY)
+    _errors++; // only count conversions that were attempted
+}
+
+/**************************************************************************/
+/*!
+    @brief Work out when the conversion in flight should next be checked,
+   the same way Adafruit_MPRLS_Manager does. With an EOC pin it can be
+   checked at any time, it costs no bus traffic
+    @param first True right after the conversion was started
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Continuous::schedulePoll(bool first) {
+  uint32_t wait = 0;
+  if (_sensor->_eoc == -1)
+    wait = first ? _sensor->_initialWait : _sensor->_pollInterval;
+  _nextPoll = micros() + wait;
+}
@@ -0,0 +1,133 @@
+/*!
+ * @file Adafruit_MPRLS_Continuous.h
+ *
+ * Free-running acquisition for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_CONTINUOUS_H
+#define ADAFRUIT_MPRLS_CONTINUOUS_H
+
+#include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Filter.h"
+
+#if defined(__AVR__)
+typedef uint8_t mprls_index_t; ///< Queue index, 8 bit so access is atomic
+/*! Single core, volatile access is enough to see the other side's index */
+#define MPRLS_LOAD_ACQUIRE(x) (x)
+/*! Single core, volatile access is enough to publish an index */
+#define MPRLS_STORE_RELEASE(x, v) ((x) = (v))
+#else
+typedef uint16_t mprls_index_t; ///< Queue index
+/*! Read the other side's index before touching the slots it covers, so the
+ * queue also works between two cores */
+#define MPRLS_LOAD_ACQUIRE(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+/*! Publish an index only after the slots it covers are written or read */
+#define MPRLS_STORE_RELEASE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#endif
+
+/** Called from service() when a sample moved past the change threshold */
+typedef void (*MPRLS_ChangeCallback)(const mprls_sample_t *sample, void *arg);
+
+/**************************************************************************/
+/*!
+    @brief  Fixed-size single-producer/single-consumer queue of samples.
+   The storage is provided by the caller so no heap is used. One slot is
+   always kept free, so a queue holds (size - 1) samples. Only the producer
+   may call push() and only the consumer may call pop()/clear(). The two
+   sides may run on different cores, no locks are taken
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_SampleQueue {
+public:
+  Adafruit_MPRLS_SampleQueue(mprls_sample_t *buffer, mprls_index_t size);
+
+  bool push(const mprls_sample_t &sample);
+  mprls_index_t push(const mprls_sample_t *samples, mprls_index_t count);
+  bool pop(mprls_sample_t *sample);
+  mprls_index_t pop(mprls_sample_t *samples, mprls_index_t max);
+  mprls_index_t available(void);
+  void clear(void);
+
+private:
+  mprls_sample_t *_buffer;
+  mprls_index_t _size;
+  volatile mprls_index_t _head = 0; ///< Next slot to write, producer owned
+  volatile mprls_index_t _tail = 0; ///< Next slot to read, consumer owned
+};
+
+/**************************************************************************/
+/*!
+    @brief  Acquisition engine that keeps a sensor converting back-to-back
+   (or at a fixed interval) using the split-phase read path and pushes every
+   result into a sample queue. Optionally the interval adapts to the signal:
+   it stretches while the readings stay flat and snaps back on a change
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Continuous {
+public:
+  Adafruit_MPRLS_Continuous(Adafruit_MPRLS_Base *sensor,
+                            Adafruit_MPRLS_SampleQueue *queue);
+
+  bool start(uint32_t interval_us = 0);
+  void stop(void);
+  bool running(void) { return _running; } ///< True while started
+  /*! @brief Run every sample through a filter before it is queued
+   * @param filter The filter, NULL to queue the raw readings */
+  void setFilter(Adafruit_MPRLS_Filter *filter) { _filter = filter; }
+  void setBlock(mprls_sample_t *block, mprls_index_t size);
+  void setAdaptive(uint32_t max_interval_us, uint32_t deadband,
+                   uint32_t threshold);
+  void setChangeCallback(MPRLS_ChangeCallback callback, void *arg = NULL);
+  /*! @brief Time between conversion starts right now
+   * @returns Microseconds, 0 for back-to-back */
+  uint32_t interval(void) { return _interval; }
+  bool service(void);
+  bool flush(void);
+
+  /*! @brief Samples lost because the queue was full @returns Count */
+  uint32_t dropped(void) { return _dropped; }
+  /*! @brief Conversions that failed or timed out, not counting the ones an
+   * unhealthy sensor refused @returns Count */
+  uint32_t errors(void) { return _errors; }
+
+private:
+  Adafruit_MPRLS_Base *_sensor;
+  Adafruit_MPRLS_SampleQueue *_queue;
+  Adafruit_MPRLS_Filter *_filter = NULL;
+  mprls_sample_t *_block = NULL; ///< Staging for block handoff
+  mprls_index_t _blockSize = 0;
+  mprls_index_t _blockFill = 0;
+
+  uint32_t _interval = 0;
+  uint32_t _baseInterval = 0; ///< Interval given to start(), full rate
+  uint32_t _lastTrigger = 0;
+  uint32_t _nextPoll = 0; ///< micros() the sensor is due to be checked
+
+  uint32_t _maxInterval = 0; ///< Stretch limit, 0 when not adaptive
+  uint32_t _deadband = 0;    ///< Sample to sample change counted as flat
+  uint32_t _threshold = 0;   ///< Change from _reference that matters
+  uint32_t _previous = 0;    ///< Last sample, for the deadband
+  uint32_t _reference = 0;   ///< Sample the last significant change set
+  bool _haveReference = false;
+  MPRLS_ChangeCallback _changeCallback = NULL;
+  void *_changeArg = NULL;
+  bool _running = false;
+  bool _converting = false;
+  uint32_t _dropped = 0;
+  uint32_t _errors = 0;
+
+  void trigger(uint32_t now);
+  void schedulePoll(bool first);
+  bool queueSample(const mprls_sample_t &sample);
+  void adapt(const mprls_sample_t &sample);
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*!
+ * @file Adafruit_MPRLS_DutyCycle.cpp
+ *
+ * Low power periodic sampling for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_DutyCycle.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param sensor The sensor to sample, begin() must have succeeded
+    @param period_ms Time between samples in milliseconds
+*/
+/**************************************************************************/
+Adafruit_MPRLS_DutyCycle::Adafruit_MPRLS_DutyCycle(Adafruit_MPRLS_Base *sensor,
+                                                   uint32_t period_ms) {
+  _sensor = sensor;
+  _period = period_ms;
+}
+
+/**************************************************************************/
+/*!
+    @brief Sleep until the next sample is due, then take it. If the read
+   fails because the sensor stopped answering or reported an integrity
+   failure, the sensor is reset and the sample retried once
+    @param result Filled in with the reading
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_DutyCycle::sample(mprls_result_t *result) {
+  uint32_t wait = timeUntilNext();
+  if (wait) {
+    uint32_t start = micros();
+    _sensor->idle(wait * 1000UL);
+    _slept += micros() - start;
+  }
+
+  uint32_t start = micros();
+  if (!_started) {
+    _next = millis();
+    _started = true;
+  }
+  _next += _period;
+
+  *result = _sensor->readResult();
+  if (result->error == MPRLS_ERR_I2C || result->error == MPRLS_ERR_FAILED ||
+      result->error == MPRLS_ERR_UNHEALTHY) {
+    _resets++;
+    if (_sensor->reset())
+      *result = _sensor->readResult();
+  }
+  _samples++;
+
+  // the conversion wait may have slept too, but count the whole read as
+  // awake since part of it always is
+  _awake += micros() - start;
+  return result->error == MPRLS_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief How long until the next sample is due, for sketches that want to
+   do their own sleeping between calls to sample()
+    @returns Milliseconds, 0 if a sample is due now
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_DutyCycle::timeUntilNext(void) {
+  if (!_started)
+    return 0;
+
+  int32_t left = (int32_t)(_next - millis());
+  if (left <= 0) {
+    // fell behind, don't try to catch up with a burst of samples
+    if ((uint32_t)-left > _period)
+      _next = millis();
+    return 0;
+  }
+  return left;
+}
+
+/**************************************************************************/
+/*!
+    @brief Clear the sleep, awake, sample and reset counters
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_DutyCycle::resetCounters(void) {
+  _slept = 0;
+  _awake = 0;
+  _samples = 0;
+  _resets = 0;
+}
@@ -0,0 +1,60 @@
+/*!
+ * @file Adafruit_MPRLS_DutyCycle.h
+ *
+ * Low power periodic sampling for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_DUTYCYCLE_H
+#define ADAFRUIT_MPRLS_DUTYCYCLE_H
+
+#include "Adafruit_MPRLS.h"
+
+/**************************************************************************/
+/*!
+    @brief  Takes one sample every period and keeps the MCU asleep the rest
+   of the time. Sleeping is done through the sensor's sleep callback (see
+   Adafruit_MPRLS::setSleepCallback()); with the EOC interrupt enabled the
+   MCU also sleeps through the conversion. A sensor that stops answering is
+   brought back with the reset pin instead of a full begin()
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_DutyCycle {
+public:
+  Adafruit_MPRLS_DutyCycle(Adafruit_MPRLS_Base *sensor, uint32_t period_ms);
+
+  /*! @brief Change the sampling period @param period_ms Period, ms */
+  void setPeriod(uint32_t period_ms) { _period = period_ms; }
+  bool sample(mprls_result_t *result);
+  uint32_t timeUntilNext(void);
+
+  /*! @brief Time spent sleeping while sampling @returns Microseconds */
+  uint32_t sleptMicros(void) { return _slept; }
+  /*! @brief Time spent awake while sampling @returns Microseconds */
+  uint32_t awakeMicros(void) { return _awake; }
+  /*! @brief Samples taken so far @returns Count */
+  uint32_t samples(void) { return _samples; }
+  /*! @brief How often the reset pin was needed @returns Count */
+  uint32_t resets(void) { return _resets; }
+  void resetCounters(void);
+
+private:
+  Adafruit_MPRLS_Base *_sensor;
+  uint32_t _period;
+  uint32_t _next = 0;    ///< millis() of the next sample
+  bool _started = false; ///< _next is valid
+
+  uint32_t _slept = 0;
+  uint32_t _awake = 0;
+  uint32_t _samples = 0;
+  uint32_t _resets = 0;
+};
+
+#endif
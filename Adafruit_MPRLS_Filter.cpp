@@ -0,0 +1,123 @@
+/*!
+ * @file Adafruit_MPRLS_Filter.cpp
+ *
+ * Integer filtering of raw readings from the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Filter.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor, the filter starts as a pass-through
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Filter::Adafruit_MPRLS_Filter(void) {
+  memset(_window, 0, sizeof(_window));
+}
+
+/**************************************************************************/
+/*!
+    @brief Configure the exponential moving average. The float is only used
+   here, the filter itself runs in integer math
+    @param alpha Weight of a new sample from 0 to 1, smaller values smooth
+   more. 1 turns the average off
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Filter::setEMA(float alpha) {
+  if (alpha <= 0)
+    alpha = 1.0 / 65536;
+  if (alpha > 1)
+    alpha = 1;
+  _alpha = (uint32_t)(alpha * 65536 + 0.5);
+}
+
+/**************************************************************************/
+/*!
+    @brief Configure the moving median that runs before the average
+    @param size Number of samples in the window, odd and no more than
+   MPRLS_FILTER_MAX_WINDOW. 1 turns the median off
+    @returns True on success, False if the size is not usable
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Filter::setMedianWindow(uint8_t size) {
+  if (size == 0 || size > MPRLS_FILTER_MAX_WINDOW || !(size & 1))
+    return false;
+
+  _size = size;
+  _count = 0;
+  _next = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Forget all history, the next sample starts the filter afresh
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Filter::reset(void) {
+  _primed = false;
+  _count = 0;
+  _next = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Feed one raw reading through the filter
+    @param raw 24 bits of raw ADC reading, failed reads (0xFFFFFFFF) must
+   not be fed in
+    @returns The filtered reading in raw counts
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Filter::process(uint32_t raw) {
+  raw &= 0xFFFFFF;
+
+  if (_size > 1) {
+    _window[_next] = raw;
+    if (++_next == _size)
+      _next = 0;
+    if (_count < _size)
+      _count++;
+    raw = median();
+  }
+
+  int32_t x = (int32_t)(raw << 7); // 24 bits still fit with 7 fractional
+  if (!_primed || _alpha >= 65536) {
+    _ema = x;
+    _primed = true;
+  } else {
+    _ema += (int32_t)(((int64_t)(x - _ema) * _alpha) >> 16);
+  }
+
+  _value = (uint32_t)(_ema + 64) >> 7;
+  return _value;
+}
+
+/**************************************************************************/
+/*!
+    @brief Median of the samples currently in the window
+    @returns The median in raw counts
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Filter::median(void) {
+  uint32_t sorted[MPRLS_FILTER_MAX_WINDOW];
+
+  // the window is tiny, insertion sort a copy
+  for (uint8_t i = 0; i < _count; i++) {
+    uint32_t v = _window[i];
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1] > v) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+  return sorted[_count / 2];
+}
@@ -0,0 +1,55 @@
+/*!
+ * @file Adafruit_MPRLS_Filter.h
+ *
+ * Integer filtering of raw readings from the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_FILTER_H
+#define ADAFRUIT_MPRLS_FILTER_H
+
+#include "Adafruit_MPRLS.h"
+
+#define MPRLS_FILTER_MAX_WINDOW (9) ///< Largest moving median window
+
+/**************************************************************************/
+/*!
+    @brief  Streaming filter for raw 24 bit counts: an optional moving
+   median to reject spikes followed by an optional exponential moving
+   average, both in fixed point integer math with bounded memory
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Filter {
+public:
+  Adafruit_MPRLS_Filter(void);
+
+  void setEMA(float alpha);
+  bool setMedianWindow(uint8_t size);
+  void reset(void);
+
+  uint32_t process(uint32_t raw);
+  /*! @brief The last filter output @returns Raw counts */
+  uint32_t value(void) { return _value; }
+
+private:
+  uint32_t _alpha = 65536; ///< EMA weight of a new sample, Q16
+  int32_t _ema = 0;        ///< EMA state, counts in Q24.7
+  bool _primed = false;    ///< _ema holds a value
+  uint32_t _value = 0;     ///< Last output
+
+  uint32_t _window[MPRLS_FILTER_MAX_WINDOW]; ///< Last raw samples
+  uint8_t _size = 1;                         ///< Median window size
+  uint8_t _count = 0;                        ///< Samples in the window
+  uint8_t _next = 0;                         ///< Window slot to fill next
+
+  uint32_t median(void);
+};
+
+#endif
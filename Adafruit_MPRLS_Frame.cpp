@@ -0,0 +1,112 @@
+/*!
+ * @file Adafruit_MPRLS_Frame.cpp
+ *
+ * Compact binary frames for streaming MPRLS samples to a host
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Frame.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param sensorID ID put in every frame, so several sensors can share one
+   link
+    @param keyInterval Frames between absolute time frames, 0 to only send
+   one at the start and whenever the delta overflows
+*/
+/**************************************************************************/
+Adafruit_MPRLS_FrameEncoder::Adafruit_MPRLS_FrameEncoder(uint8_t sensorID,
+                                                         uint16_t keyInterval) {
+  _sensorID = sensorID;
+  _keyInterval = keyInterval;
+  _sinceKey = 0xFFFF; // start with an absolute time frame
+}
+
+/**************************************************************************/
+/*!
+    @brief Encode one sample
+    @param sample The sample, only the low 24 bits of raw and the low 8 bits
+   of the sequence number are sent
+    @param buffer At least MPRLS_FRAME_MAX_LEN bytes
+    @returns The number of bytes written to buffer
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_FrameEncoder::encode(const mprls_sample_t &sample,
+                                            uint8_t *buffer) {
+  uint32_t delta = sample.timestamp - _lastTimestamp;
+  uint8_t sequence = sample.sequence;
+  // after a gap the host can't tell a failed conversion from a lost frame,
+  // so give it a fresh timestamp either way
+  bool key = (delta > 0xFFFF) || (_sinceKey >= _keyInterval && _keyInterval) ||
+             (_sinceKey == 0xFFFF) ||
+             (sequence != (uint8_t)(_lastSequence + 1));
+  uint8_t len;
+
+  buffer[1] = _sensorID;
+  buffer[2] = sequence;
+  buffer[3] = sample.raw >> 16;
+  buffer[4] = sample.raw >> 8;
+  buffer[5] = sample.raw;
+
+  if (key) {
+    buffer[0] = MPRLS_FRAME_KEY;
+    buffer[6] = sample.timestamp;
+    buffer[7] = sample.timestamp >> 8;
+    buffer[8] = sample.timestamp >> 16;
+    buffer[9] = sample.timestamp >> 24;
+    len = MPRLS_FRAME_KEY_LEN;
+    _sinceKey = 0;
+  } else {
+    buffer[0] = MPRLS_FRAME_DELTA;
+    buffer[6] = delta;
+    buffer[7] = delta >> 8;
+    len = MPRLS_FRAME_DELTA_LEN;
+    _sinceKey++;
+  }
+
+  buffer[len - 1] = crc8(buffer, len - 1);
+  _lastTimestamp = sample.timestamp;
+  _lastSequence = sequence;
+  return len;
+}
+
+/**************************************************************************/
+/*!
+    @brief Encode one sample and send it
+    @param out Where to write the frame, e.g. Serial
+    @param sample The sample
+    @returns The number of bytes written
+*/
+/**************************************************************************/
+size_t Adafruit_MPRLS_FrameEncoder::write(Print &out,
+                                          const mprls_sample_t &sample) {
+  uint8_t buffer[MPRLS_FRAME_MAX_LEN];
+  return out.write(buffer, encode(sample, buffer));
+}
+
+/**************************************************************************/
+/*!
+    @brief CRC-8 as used by the frames: polynomial 0x07, initial value 0,
+   no reflection, no final xor (CRC-8/SMBUS)
+    @param data Bytes to check
+    @param len Number of bytes
+    @returns The CRC
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_FrameEncoder::crc8(const uint8_t *data, size_t len) {
+  uint8_t crc = 0;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file Adafruit_MPRLS_Frame.h
+ *
+ * Compact binary frames for streaming MPRLS samples to a host
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_FRAME_H
+#define ADAFRUIT_MPRLS_FRAME_H
+
+#include "Adafruit_MPRLS.h"
+
+#define MPRLS_FRAME_DELTA (0xA5)  ///< Sync byte of a delta timestamp frame
+#define MPRLS_FRAME_KEY (0xA6)    ///< Sync byte of an absolute time frame
+#define MPRLS_FRAME_DELTA_LEN (9) ///< Bytes in a delta timestamp frame
+#define MPRLS_FRAME_KEY_LEN (11)  ///< Bytes in an absolute time frame
+#define MPRLS_FRAME_MAX_LEN (11)  ///< Buffer size needed by encode()
+#define MPRLS_FRAME_KEY_INTERVAL                                               \
+  (64) ///< Default frames between absolute time frames
+
+/**************************************************************************/
+/*!
+    @brief  Packs samples into small binary frames: the low byte of the
+   sequence number, 3 byte raw counts, a 16 bit timestamp delta and a CRC-8,
+   with a frame carrying the full 32 bit timestamp now and then so a host
+   can pick the stream up at any point. A gap in the sequence (a failed
+   conversion) is always followed by an absolute time frame, so a host that
+   sees a gap before a delta frame knows frames were lost. Use one encoder
+   per sensor. The format is described in extras/frame_format.md
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_FrameEncoder {
+public:
+  Adafruit_MPRLS_FrameEncoder(uint8_t sensorID = 0,
+                              uint16_t keyInterval = MPRLS_FRAME_KEY_INTERVAL);
+
+  uint8_t encode(const mprls_sample_t &sample, uint8_t *buffer);
+  size_t write(Print &out, const mprls_sample_t &sample);
+  /*! @brief Make the next frame an absolute time frame */
+  void reset(void) { _sinceKey = _keyInterval; }
+
+  static uint8_t crc8(const uint8_t *data, size_t len);
+
+private:
+  uint8_t _sensorID;
+  uint16_t _keyInterval;
+  uint16_t _sinceKey; ///< Frames since the last absolute time frame
+  uint32_t _lastTimestamp = 0;
+  uint8_t _lastSequence = 0; ///< Low byte of the last sample's sequence
+};
+
+#endif
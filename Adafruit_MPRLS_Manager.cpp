@@ -0,0 +1,323 @@
+/*!
+ * @file Adafruit_MPRLS_Manager.cpp
+ *
+ * Pipelined reading of many MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Manager.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor for an empty manager
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Manager::Adafruit_MPRLS_Manager(void) {
+  for (uint8_t i = 0; i < MPRLS_MANAGER_MAX_SENSORS; i++) {
+    _sensors[i] = NULL;
+    _channels[i] = -1;
+    _recovery[i] = NULL;
+    _results[i] = 0xFFFFFFFF;
+    _nextPoll[i] = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Add a sensor, either call begin() on it first or bring all
+   sensors up together with beginAll()
+    @param sensor The sensor to manage
+    @param channel Multiplexer channel the sensor sits behind, -1 if it is
+   directly on the bus
+    @returns The index of the sensor, or -1 if the manager is full
+*/
+/**************************************************************************/
+int8_t Adafruit_MPRLS_Manager::addSensor(Adafruit_MPRLS_Base *sensor,
+                                         int8_t channel) {
+  if (_count >= MPRLS_MANAGER_MAX_SENSORS)
+    return -1;
+
+  _sensors[_count] = sensor;
+  _channels[_count] = channel;
+  return _count++;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set the function used to switch the multiplexer. It is only
+   called when the next sensor sits on a different channel than the last one
+    @param callback Function that selects a multiplexer channel
+    @param arg Pointer passed through to the callback
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Manager::setSelectCallback(MPRLS_SelectCallback callback,
+                                               void *arg) {
+  _select = callback;
+  _selectArg = arg;
+  _selected = -1;
+}
+
+/**************************************************************************/
+/*!
+    @brief Have a sensor brought back automatically once it is marked
+   unhealthy. Its recovery is advanced by startAll() and service() while the
+   other sensors keep being read
+    @param index Index returned by addSensor()
+    @param recovery Recovery for that sensor, NULL for none
+    @returns False if there is no such sensor
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Manager::setRecovery(uint8_t index,
+                                         Adafruit_MPRLS_Recovery *recovery) {
+  if (index >= _count)
+    return false;
+  _recovery[index] = recovery;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Start bringing up one sensor without waiting for its reset and
+   startup timing, see Adafruit_MPRLS::beginAsync()
+    @param index Index returned by addSensor()
+    @param i2c_addr The I2C address of the sensor
+    @param twoWire The TwoWire I2C object the sensor (or its multiplexer) is
+   on
+    @returns True if the startup was started, False if the sensor was not
+   found
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Manager::beginAsync(uint8_t index, uint8_t i2c_addr,
+                                        TwoWire *twoWire) {
+  if (index >= _count)
+    return false;
+
+  select(index);
+  if (!_sensors[index]->beginAsync(i2c_addr, twoWire))
+    return false;
+  _beginPending |= (1 << index);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Advance the startup of every sensor started with beginAsync(),
+   never blocks
+    @returns The number of sensors still starting up
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Manager::pollBegin(void) {
+  uint8_t remaining = 0;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!(_beginPending & (1 << i)))
+      continue;
+
+    select(i);
+    if (_sensors[i]->pollBegin() == MPRLS_BEGIN_PENDING)
+      remaining++;
+    else
+      _beginPending &= ~(1 << i);
+  }
+  return remaining;
+}
+
+/**************************************************************************/
+/*!
+    @brief Bring up all sensors in parallel: every reset pulse and startup
+   wait overlaps, so this takes about as long as a single begin()
+    @param i2c_addr The I2C address, the same for all sensors (e.g. when
+   they are behind a multiplexer)
+    @param twoWire The TwoWire I2C object
+    @returns The number of sensors that report powered
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Manager::beginAll(uint8_t i2c_addr, TwoWire *twoWire) {
+  _selected = -1; // someone else may have moved the multiplexer
+  for (uint8_t i = 0; i < _count; i++)
+    beginAsync(i, i2c_addr, twoWire);
+
+  while (pollBegin())
+    yield();
+
+  uint8_t good = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_sensors[i]->isHealthy())
+      good++;
+  }
+  return good;
+}
+
+/**************************************************************************/
+/*!
+    @brief Start a conversion on every sensor without waiting for any of them
+    @returns The number of sensors a conversion was started on
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Manager::startAll(void) {
+  uint8_t started = 0;
+
+  _pending = 0;
+  _selected = -1; // someone else may have moved the multiplexer
+
+  for (uint8_t i = 0; i < _count; i++) {
+    _results[i] = 0xFFFFFFFF;
+    select(i);
+    if (!recover(i))
+      continue; // skipped this sweep
+    if (_sensors[i]->startConversion()) {
+      schedulePoll(i, true);
+      _pending |= (1 << i);
+      started++;
+    }
+  }
+  return started;
+}
+
+/**************************************************************************/
+/*!
+    @brief Non-blocking collection step: read every sensor whose conversion
+   has completed. A sensor's status is only polled once its initial wait,
+   and after that its poll interval, has passed (see
+   Adafruit_MPRLS::setPollingStrategy()), so calling this often doesn't
+   flood the bus. Sensors that did not finish within their timeout are given
+   up on and report 0xFFFFFFFF
+    @returns The number of sensors still pending
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Manager::service(void) {
+  uint8_t remaining = 0;
+  uint32_t now = micros();
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!(_pending & (1 << i))) {
+      if (_recovery[i] && _recovery[i]->state() != MPRLS_RECOVERY_HEALTHY) {
+        select(i);
+        recover(i);
+      }
+      continue;
+    }
+
+    if ((int32_t)(now - _nextPoll[i]) < 0) {
+      remaining++; // not due yet
+      continue;
+    }
+
+    select(i);
+    if (_sensors[i]->isReady()) {
+      _results[i] = _sensors[i]->fetchResult();
+      _pending &= ~(1 << i);
+    } else if (!_sensors[i]->conversionPending() ||
+               _sensors[i]->checkTimeout()) {
+      _pending &= ~(1 << i);
+    } else {
+      schedulePoll(i, false);
+      remaining++;
+    }
+  }
+  return remaining;
+}
+
+/**************************************************************************/
+/*!
+    @brief Blocking sweep: start all conversions, then collect them as they
+   complete
+    @param raw Optional array of count() elements to copy the raw readings
+   into, failed sensors report 0xFFFFFFFF
+    @returns The number of sensors read successfully
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_Manager::readAll(uint32_t *raw) {
+  startAll();
+  while (service()) {
+    // sleep until the first sensor is due, with that sensor's idle()
+    uint8_t next = 0;
+    int32_t wait = 0x7FFFFFFF;
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < _count; i++) {
+      int32_t due = (int32_t)(_nextPoll[i] - now);
+      if ((_pending & (1 << i)) && due < wait) {
+        wait = due;
+        next = i;
+      }
+    }
+    if (wait > 0)
+      _sensors[next]->idle(wait);
+    else
+      yield();
+  }
+
+  uint8_t good = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (raw)
+      raw[i] = _results[i];
+    if (_results[i] != 0xFFFFFFFF)
+      good++;
+  }
+  return good;
+}
+
+/**************************************************************************/
+/*!
+    @brief Get the raw reading of a sensor from the last sweep
+    @param index Index returned by addSensor()
+    @returns 24 bits of raw ADC reading, 0xFFFFFFFF on failure or if the
+   sensor is still pending
+*/
+/**************************************************************************/
+uint32_t Adafruit_MPRLS_Manager::result(uint8_t index) {
+  if (index >= _count)
+    return 0xFFFFFFFF;
+  return _results[index];
+}
+
+/**************************************************************************/
+/*!
+    @brief Advance the recovery of a sensor, the bus must be selected
+    @param index Sensor index
+    @returns True if the sensor can be used right now
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Manager::recover(uint8_t index) {
+  if (!_recovery[index])
+    return true; // fails fast in startConversion() if unhealthy
+  return _recovery[index]->service() == MPRLS_RECOVERY_HEALTHY;
+}
+
+/**************************************************************************/
+/*!
+    @brief Work out when a converting sensor should next be checked. Sensors
+   with an EOC pin can be checked at any time, it costs no bus traffic
+    @param index Sensor index
+    @param first True right after the conversion was started
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Manager::schedulePoll(uint8_t index, bool first) {
+  Adafruit_MPRLS_Base *sensor = _sensors[index];
+  uint32_t wait = 0;
+  if (sensor->_eoc == -1)
+    wait = first ? sensor->_initialWait : sensor->_pollInterval;
+  _nextPoll[index] = micros() + wait;
+}
+
+/**************************************************************************/
+/*!
+    @brief Route the bus to the multiplexer channel of a sensor if needed
+    @param index Sensor index
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Manager::select(uint8_t index) {
+  int8_t channel = _channels[index];
+  if (channel == -1 || !_select || channel == _selected)
+    return;
+
+  _select(channel, _selectArg);
+  _selected = channel;
+}
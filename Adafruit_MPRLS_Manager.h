@@ -0,0 +1,80 @@
+/*!
+ * @file Adafruit_MPRLS_Manager.h
+ *
+ * Pipelined reading of many MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_MANAGER_H
+#define ADAFRUIT_MPRLS_MANAGER_H
+
+#include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Recovery.h"
+
+#define MPRLS_MANAGER_MAX_SENSORS (8) ///< Sensors one manager can hold
+
+/** Callback that routes the bus to a multiplexer channel, e.g. a TCA9548A */
+typedef void (*MPRLS_SelectCallback)(uint8_t channel, void *arg);
+
+/**************************************************************************/
+/*!
+    @brief  Holds many Adafruit_MPRLS sensors and overlaps their
+   conversions: all conversions are started first, then the results are
+   collected in whatever order they complete, so a sweep over N sensors takes
+   about as long as a single conversion. Sensors that stop working are left
+   out of the sweeps, and with setRecovery() brought back in the background
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Manager {
+public:
+  Adafruit_MPRLS_Manager(void);
+
+  int8_t addSensor(Adafruit_MPRLS_Base *sensor, int8_t channel = -1);
+  void setSelectCallback(MPRLS_SelectCallback callback, void *arg = NULL);
+  bool setRecovery(uint8_t index, Adafruit_MPRLS_Recovery *recovery);
+
+  /*! @brief Number of sensors added @returns Count */
+  uint8_t count(void) { return _count; }
+
+  bool beginAsync(uint8_t index, uint8_t i2c_addr = MPRLS_DEFAULT_ADDR,
+                  TwoWire *twoWire = &Wire);
+  uint8_t pollBegin(void);
+  uint8_t beginAll(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR,
+                   TwoWire *twoWire = &Wire);
+
+  uint8_t startAll(void);
+  uint8_t service(void);
+  uint8_t readAll(uint32_t *raw = NULL);
+
+  /*! @brief Check if a sweep is still collecting results @returns True if
+   * at least one sensor has not been read yet */
+  bool busy(void) { return _pending != 0; }
+  uint32_t result(uint8_t index);
+
+private:
+  Adafruit_MPRLS_Base *_sensors[MPRLS_MANAGER_MAX_SENSORS];
+  int8_t _channels[MPRLS_MANAGER_MAX_SENSORS];
+  Adafruit_MPRLS_Recovery *_recovery[MPRLS_MANAGER_MAX_SENSORS];
+  uint32_t _results[MPRLS_MANAGER_MAX_SENSORS];
+  uint32_t _nextPoll[MPRLS_MANAGER_MAX_SENSORS]; ///< micros() of next poll
+  uint8_t _count = 0;
+  uint8_t _pending = 0;      ///< Bitmask of sensors still converting
+  uint8_t _beginPending = 0; ///< Bitmask of sensors still starting up
+
+  MPRLS_SelectCallback _select = NULL;
+  void *_selectArg = NULL;
+  int8_t _selected = -1; ///< Multiplexer channel currently routed
+
+  void select(uint8_t index);
+  void schedulePoll(uint8_t index, bool first);
+  bool recover(uint8_t index);
+};
+
+#endif
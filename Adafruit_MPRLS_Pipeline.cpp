@@ -0,0 +1,127 @@
+/*!
+ * @file Adafruit_MPRLS_Pipeline.cpp
+ *
+ * Dual-core acquisition pipeline for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Pipeline.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param engine The engine to run on the acquisition core, use
+   Adafruit_MPRLS_Continuous::setBlock() on it for block handoff
+    @param queue The queue the engine pushes into
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Pipeline::Adafruit_MPRLS_Pipeline(
+    Adafruit_MPRLS_Continuous *engine, Adafruit_MPRLS_SampleQueue *queue) {
+  _engine = engine;
+  _queue = queue;
+}
+
+/**************************************************************************/
+/*!
+    @brief Ask the acquisition core to start sampling, application core
+    @param interval_us Time between conversion starts, see
+   Adafruit_MPRLS_Continuous::start()
+    @param core Core for the acquisition task on ESP32, -1 for either.
+   Ignored elsewhere, produce() runs wherever it is called from
+    @returns True if the request was made, False if the ESP32 task could
+   not be created
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Pipeline::start(uint32_t interval_us, int8_t core) {
+  _interval = interval_us;
+  MPRLS_STORE_RELEASE(_generation, (uint8_t)(_generation + 1));
+  MPRLS_STORE_RELEASE(_run, true);
+
+#if defined(ESP32)
+  if (!_task &&
+      xTaskCreatePinnedToCore(producerTask, "mprls", MPRLS_PIPELINE_STACK,
+                              this, MPRLS_PIPELINE_PRIORITY, &_task,
+                              core < 0 ? tskNO_AFFINITY : core) != pdPASS) {
+    _task = NULL;
+    _run = false;
+    return false;
+  }
+#else
+  (void)core;
+#endif
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Ask the acquisition core to stop, application core. Samples
+   staged in a partly filled block are handed over first
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Pipeline::stop(void) { MPRLS_STORE_RELEASE(_run, false); }
+
+/**************************************************************************/
+/*!
+    @brief Acquisition core step, call as often as possible. Acts on
+   start()/stop() requests, then services the engine
+    @returns True if samples were handed to the queue
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Pipeline::produce(void) {
+  if (!MPRLS_LOAD_ACQUIRE(_run)) {
+    if (!_engine->running())
+      return false;
+    _engine->stop();
+    return _engine->flush();
+  }
+
+  uint8_t generation = MPRLS_LOAD_ACQUIRE(_generation);
+  if (generation != _started || !_engine->running()) {
+    _started = generation;
+    _engine->start(_interval);
+  }
+  return _engine->service();
+}
+
+/**************************************************************************/
+/*!
+    @brief Take a block of samples off the queue, application core
+    @param samples Array to copy the samples into
+    @param max Size of the samples array
+    @returns The number of samples copied
+*/
+/**************************************************************************/
+mprls_index_t Adafruit_MPRLS_Pipeline::consume(mprls_sample_t *samples,
+                                               mprls_index_t max) {
+  return _queue->pop(samples, max);
+}
+
+#if defined(ESP32)
+/**************************************************************************/
+/*!
+    @brief Body of the ESP32 acquisition task. It never blocks while
+   running so the timing stays tight, only yielding to tasks of the same
+   priority. The Arduino loop() also runs on core 1 at priority 1, so for
+   deterministic timing do the application work in a task on core 0 or move
+   the pipeline there. While stopped it sleeps a tick at a time
+    @param arg The pipeline
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Pipeline::producerTask(void *arg) {
+  Adafruit_MPRLS_Pipeline *self = (Adafruit_MPRLS_Pipeline *)arg;
+  for (;;) {
+    self->produce();
+    if (self->_run)
+      taskYIELD();
+    else
+      vTaskDelay(1);
+  }
+}
+#endif
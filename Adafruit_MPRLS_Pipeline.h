@@ -0,0 +1,68 @@
+/*!
+ * @file Adafruit_MPRLS_Pipeline.h
+ *
+ * Dual-core acquisition pipeline for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_PIPELINE_H
+#define ADAFRUIT_MPRLS_PIPELINE_H
+
+#include "Adafruit_MPRLS_Continuous.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#define MPRLS_PIPELINE_CORE 1     ///< Core the acquisition runs on
+#define MPRLS_PIPELINE_STACK 2048 ///< Acquisition task stack on ESP32
+#define MPRLS_PIPELINE_PRIORITY 1 ///< Acquisition task priority on ESP32
+
+/**************************************************************************/
+/*!
+    @brief  Runs a continuous engine on a core of its own and hands the
+   samples to the application core through the engine's lock-free queue.
+   Only the acquisition core touches the sensor and the engine; the
+   application core just asks for start/stop and drains blocks of samples.
+   On ESP32 start() creates a task pinned to the acquisition core. On other
+   dual-core boards call produce() from that core's loop, e.g. loop1() on
+   the RP2040
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Pipeline {
+public:
+  Adafruit_MPRLS_Pipeline(Adafruit_MPRLS_Continuous *engine,
+                          Adafruit_MPRLS_SampleQueue *queue);
+
+  bool start(uint32_t interval_us = 0, int8_t core = MPRLS_PIPELINE_CORE);
+  void stop(void);
+  /*! @brief Check whether acquisition was asked to run
+   * @returns True between start() and stop() */
+  bool running(void) { return _run; }
+
+  bool produce(void);
+  mprls_index_t consume(mprls_sample_t *samples, mprls_index_t max);
+
+private:
+  Adafruit_MPRLS_Continuous *_engine;
+  Adafruit_MPRLS_SampleQueue *_queue;
+  volatile bool _run = false;       ///< Asked for by the application core
+  volatile uint32_t _interval = 0;  ///< Interval for the next start
+  volatile uint8_t _generation = 0; ///< Bumped by every start()
+  uint8_t _started = 0;             ///< Generation the engine runs
+
+#if defined(ESP32)
+  TaskHandle_t _task = NULL;
+  static void producerTask(void *arg);
+#endif
+};
+
+#endif
@@ -0,0 +1,265 @@
+/*!
+ * @file Adafruit_MPRLS_RP2040.cpp
+ *
+ * DMA driven I2C transport on RP2040/RP2350 for the MPRLS sensors from
+ * Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_RP2040.h"
+
+#ifdef MPRLS_HAS_RP2040_DMA
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param i2c The controller Wire was set up on, i2c0 for Wire and i2c1 for
+   Wire1
+    @param i2c_addr The sensor's I2C address
+*/
+/**************************************************************************/
+Adafruit_MPRLS_RP2040_DMA::Adafruit_MPRLS_RP2040_DMA(i2c_inst_t *i2c,
+                                                     uint8_t i2c_addr) {
+  _i2c = i2c;
+  _addr = i2c_addr;
+}
+
+/**************************************************************************/
+/*!
+    @brief destructor, stops a transfer in flight and frees the channels
+*/
+/**************************************************************************/
+Adafruit_MPRLS_RP2040_DMA::~Adafruit_MPRLS_RP2040_DMA(void) {
+  if (_txChannel >= 0) {
+    dma_channel_abort(_txChannel);
+    dma_channel_unclaim(_txChannel);
+  }
+  if (_rxChannel >= 0) {
+    dma_channel_abort(_rxChannel);
+    dma_channel_unclaim(_rxChannel);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Claim the DMA channels and check the sensor answers
+    @returns True if the channels were free and the sensor was found
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::begin(void) {
+  if (_txChannel < 0)
+    _txChannel = dma_claim_unused_channel(false);
+  if (_rxChannel < 0)
+    _rxChannel = dma_claim_unused_channel(false);
+  if (_txChannel < 0 || _rxChannel < 0)
+    return false;
+
+  // the SDK turns these on in i2c_init(), make sure nobody turned them off
+  i2c_get_hw(_i2c)->dma_cr =
+      I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+
+  uint8_t status;
+  return read(&status, 1);
+}
+
+/**************************************************************************/
+/*!
+    @brief Blocking read, runs the DMA transfer and waits for it
+    @param buffer Where to put the data
+    @param len Number of bytes to read, at most MPRLS_DMA_MAX_LEN
+    @returns True on success
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::read(uint8_t *buffer, size_t len) {
+  return readAsync(buffer, len, NULL, NULL) && wait();
+}
+
+/**************************************************************************/
+/*!
+    @brief Blocking write, runs the DMA transfer and waits for it
+    @param buffer The data to send
+    @param len Number of bytes to write, at most MPRLS_DMA_MAX_LEN
+    @returns True on success
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::write(const uint8_t *buffer, size_t len) {
+  return writeAsync(buffer, len, NULL, NULL) && wait();
+}
+
+/**************************************************************************/
+/*!
+    @brief Start a DMA read, see Adafruit_MPRLS_Transport::readAsync()
+    @param buffer Where to put the data, must stay valid until the callback
+    @param len Number of bytes to read, at most MPRLS_DMA_MAX_LEN
+    @param callback Called from busy() once the read is done
+    @param arg Pointer passed through to the callback
+    @returns True if the read was started
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::readAsync(uint8_t *buffer, size_t len,
+                                          MPRLS_TransferCallback callback,
+                                          void *arg) {
+  if (_pending || _rxChannel < 0 || !len || len > MPRLS_DMA_MAX_LEN)
+    return false;
+
+  // every byte read is asked for with a read command, STOP after the last
+  for (size_t i = 0; i < len; i++)
+    _cmd[i] = I2C_IC_DATA_CMD_CMD_BITS |
+              (i == len - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+  _buffer = buffer;
+  return start(len, callback, arg);
+}
+
+/**************************************************************************/
+/*!
+    @brief Start a DMA write, see Adafruit_MPRLS_Transport::writeAsync()
+    @param buffer The data to send, copied before this returns
+    @param len Number of bytes to write, at most MPRLS_DMA_MAX_LEN
+    @param callback Called from busy() once the write is done
+    @param arg Pointer passed through to the callback
+    @returns True if the write was started
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::writeAsync(const uint8_t *buffer, size_t len,
+                                           MPRLS_TransferCallback callback,
+                                           void *arg) {
+  if (_pending || _txChannel < 0 || !len || len > MPRLS_DMA_MAX_LEN)
+    return false;
+
+  for (size_t i = 0; i < len; i++)
+    _cmd[i] = buffer[i] | (i == len - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+  _buffer = NULL;
+  return start(len, callback, arg);
+}
+
+/**************************************************************************/
+/*!
+    @brief Check on the transfer in flight, finishing it (and calling its
+   callback) once the controller has sent the STOP or given up
+    @returns True while a transfer is still running
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::busy(void) {
+  if (!_pending)
+    return false;
+
+  i2c_hw_t *hw = i2c_get_hw(_i2c);
+  uint32_t raw = hw->raw_intr_stat;
+  if (raw & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    // NACK or lost arbitration, the controller has flushed its FIFO and
+    // the channels would wait forever for it
+    dma_channel_abort(_txChannel);
+    dma_channel_abort(_rxChannel);
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+    finish(false);
+    return false;
+  }
+  if (!(raw & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+    return true;
+  // the last byte may still be on its way out of the RX FIFO
+  if (_buffer && dma_channel_is_busy(_rxChannel))
+    return true;
+
+  (void)hw->clr_stop_det;
+  finish(true);
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Address the sensor and set the channels going, the command words
+   are already in _cmd
+    @param len Number of bytes to transfer
+    @param callback Called once the transfer is done
+    @param arg Pointer passed through to the callback
+    @returns True, the transfer is running
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::start(size_t len,
+                                      MPRLS_TransferCallback callback,
+                                      void *arg) {
+  i2c_hw_t *hw = i2c_get_hw(_i2c);
+
+  _len = len;
+  _callback = callback;
+  _arg = arg;
+  _pending = true;
+
+  // the target address can only change with the controller disabled
+  hw->enable = 0;
+  hw->tar = _addr;
+  hw->enable = 1;
+  (void)hw->clr_tx_abrt;
+  (void)hw->clr_stop_det;
+
+  // receive side first so no byte arrives before it is listening
+  if (_buffer) {
+    dma_channel_config rx = dma_channel_get_default_config(_rxChannel);
+    channel_config_set_transfer_data_size(&rx, DMA_SIZE_32);
+    channel_config_set_read_increment(&rx, false);
+    channel_config_set_write_increment(&rx, true);
+    channel_config_set_dreq(&rx, i2c_get_dreq(_i2c, false));
+    dma_channel_configure(_rxChannel, &rx, _rx, &hw->data_cmd, len, true);
+  }
+
+  dma_channel_config tx = dma_channel_get_default_config(_txChannel);
+  channel_config_set_transfer_data_size(&tx, DMA_SIZE_32);
+  channel_config_set_read_increment(&tx, true);
+  channel_config_set_write_increment(&tx, false);
+  channel_config_set_dreq(&tx, i2c_get_dreq(_i2c, true));
+  dma_channel_configure(_txChannel, &tx, &hw->data_cmd, _cmd, len, true);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Spin on busy() until the transfer is done, aborting it if the bus
+   is stuck
+    @returns True if the transfer succeeded
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RP2040_DMA::wait(void) {
+  uint32_t start = micros();
+  while (busy()) {
+    if (micros() - start > MPRLS_DMA_TIMEOUT_US) {
+      dma_channel_abort(_txChannel);
+      dma_channel_abort(_rxChannel);
+      // the abort bit makes the controller STOP and flush
+      i2c_get_hw(_i2c)->enable =
+          I2C_IC_ENABLE_ENABLE_BITS | I2C_IC_ENABLE_ABORT_BITS;
+      finish(false);
+    }
+  }
+  return _ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Hand a finished transfer's bytes over and report it
+    @param ok True if the transfer succeeded
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_RP2040_DMA::finish(bool ok) {
+  if (ok && _buffer) {
+    for (size_t i = 0; i < _len; i++)
+      _buffer[i] = (uint8_t)_rx[i];
+  }
+  _pending = false;
+  _ok = ok;
+
+  // the callback may start the next transfer
+  MPRLS_TransferCallback callback = _callback;
+  _callback = NULL;
+  if (callback)
+    callback(ok, _arg);
+}
+
+#endif // MPRLS_HAS_RP2040_DMA
@@ -0,0 +1,84 @@
+/*!
+ * @file Adafruit_MPRLS_RP2040.h
+ *
+ * DMA driven I2C transport on RP2040/RP2350 for the MPRLS sensors from
+ * Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_RP2040_H
+#define ADAFRUIT_MPRLS_RP2040_H
+
+#include "Adafruit_MPRLS.h"
+
+// the Arduino-Pico core, the mbed one doesn't expose the pico-sdk hardware
+#if defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)
+#define MPRLS_HAS_RP2040_DMA ///< The RP2040 DMA transport is compiled in
+#endif
+
+#ifdef MPRLS_HAS_RP2040_DMA
+
+#include <hardware/dma.h>
+#include <hardware/i2c.h>
+
+#define MPRLS_DMA_MAX_LEN 4 ///< Longest MPRLS transfer, the result read
+#define MPRLS_DMA_TIMEOUT_US                                                   \
+  (10000) ///< Give up on a blocking transfer after this long
+
+/**************************************************************************/
+/*!
+    @brief  Transport that moves the bytes with DMA straight to and from the
+   I2C controller, so the CPU is free while the command goes out and the
+   result comes back. One channel feeds the command words (with STOP on the
+   last) into the controller, a second one, for reads, drains the received
+   bytes. Completion is noticed in busy(), which isReady() calls, so the
+   callbacks run from the sketch's own polling rather than an interrupt.
+   Wire must have been set up (pins and speed) before begin(), and nothing
+   else may use the same controller while a transfer is running
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_RP2040_DMA : public Adafruit_MPRLS_Transport {
+public:
+  Adafruit_MPRLS_RP2040_DMA(i2c_inst_t *i2c = i2c0,
+                            uint8_t i2c_addr = MPRLS_DEFAULT_ADDR);
+  ~Adafruit_MPRLS_RP2040_DMA(void);
+
+  bool begin(void);
+  bool read(uint8_t *buffer, size_t len);
+  bool write(const uint8_t *buffer, size_t len);
+  bool readAsync(uint8_t *buffer, size_t len, MPRLS_TransferCallback callback,
+                 void *arg);
+  bool writeAsync(const uint8_t *buffer, size_t len,
+                  MPRLS_TransferCallback callback, void *arg);
+  bool busy(void);
+
+private:
+  i2c_inst_t *_i2c;
+  uint8_t _addr;
+  int _txChannel = -1;
+  int _rxChannel = -1;
+
+  uint32_t _cmd[MPRLS_DMA_MAX_LEN]; ///< Words for the data/command register
+  uint32_t _rx[MPRLS_DMA_MAX_LEN];  ///< Received words, data in the low byte
+  uint8_t *_buffer = NULL;          ///< Where a read's bytes go
+  size_t _len = 0;
+  bool _pending = false;
+  bool _ok = false; ///< Outcome of the last transfer
+  MPRLS_TransferCallback _callback = NULL;
+  void *_arg = NULL;
+
+  bool start(size_t len, MPRLS_TransferCallback callback, void *arg);
+  bool wait(void);
+  void finish(bool ok);
+};
+
+#endif // MPRLS_HAS_RP2040_DMA
+
+#endif
@@ -0,0 +1,332 @@
+/*!
+ * @file Adafruit_MPRLS_RTOS.cpp
+ *
+ * FreeRTOS integration for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_RTOS.h"
+
+#ifdef MPRLS_HAS_FREERTOS
+
+/*! @brief Milliseconds to ticks, never 0 so a delay always blocks
+ *  @param ms Milliseconds @returns Ticks */
+static TickType_t msToTicks(uint32_t ms) {
+  TickType_t ticks = pdMS_TO_TICKS(ms);
+  return ticks ? ticks : 1;
+}
+
+/*! @brief Microseconds to ticks, rounded up
+ *  @param us Microseconds @returns Ticks */
+static TickType_t usToTicks(uint32_t us) {
+  return msToTicks((us + 999) / 1000);
+}
+
+/*! @brief Block for at least a while, or just yield the CPU if it is 0
+ *  @param us Microseconds */
+static void sleepUs(uint32_t us) {
+  if (us)
+    vTaskDelay(usToTicks(us));
+  else
+    taskYIELD();
+}
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param sensor The sensor to share between tasks
+    @param busMutex Mutex already guarding the bus (e.g. shared with other
+   drivers on Wire), NULL to create one in begin()
+*/
+/**************************************************************************/
+Adafruit_MPRLS_RTOS::Adafruit_MPRLS_RTOS(Adafruit_MPRLS *sensor,
+                                         SemaphoreHandle_t busMutex) {
+  _sensor = sensor;
+  _busMutex = busMutex;
+}
+
+/**************************************************************************/
+/*!
+    @brief destructor, stops the sampler task and frees the semaphores
+*/
+/**************************************************************************/
+Adafruit_MPRLS_RTOS::~Adafruit_MPRLS_RTOS(void) {
+  stopSampler();
+  if (_eocIRQ)
+    _sensor->disableEOCInterrupt();
+  if (_ready)
+    vSemaphoreDelete(_ready);
+  if (_sensorMutex)
+    vSemaphoreDelete(_sensorMutex);
+  if (_ownBusMutex)
+    vSemaphoreDelete(_busMutex);
+}
+
+/**************************************************************************/
+/*!
+    @brief Create the semaphores, start up the sensor with the bus held and
+   route its EOC interrupt (if it has an EOC pin) to the ready semaphore
+    @param i2c_addr The I2C address for the sensor
+    @param twoWire The TwoWire I2C object
+    @returns True on sensor initialization success
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::begin(uint8_t i2c_addr, TwoWire *twoWire) {
+  if (!_busMutex) {
+    _busMutex = xSemaphoreCreateMutex();
+    _ownBusMutex = true;
+  }
+  if (!_sensorMutex)
+    _sensorMutex = xSemaphoreCreateMutex();
+  if (!_ready)
+    _ready = xSemaphoreCreateBinary();
+  if (!_busMutex || !_sensorMutex || !_ready)
+    return false;
+
+  xSemaphoreTake(_sensorMutex, portMAX_DELAY);
+  xSemaphoreTake(_busMutex, portMAX_DELAY);
+  bool ok = _sensor->begin(i2c_addr, twoWire);
+  xSemaphoreGive(_busMutex);
+  // fails harmlessly when there is no EOC pin, we poll instead
+  _eocIRQ = ok && _sensor->enableEOCInterrupt(eocGive, this);
+  xSemaphoreGive(_sensorMutex);
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Take a reading, blocking the calling task (not spinning) while the
+   sensor converts
+    @param result Filled in with the reading, error code and status byte
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::read(mprls_result_t *result) {
+  xSemaphoreTake(_sensorMutex, portMAX_DELAY);
+  bool ok = collect(result);
+  xSemaphoreGive(_sensorMutex);
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Take a timestamped reading, blocking the calling task while the
+   sensor converts
+    @param sample Filled in with the reading, see Adafruit_MPRLS::readSample()
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::readSample(mprls_sample_t *sample) {
+  mprls_result_t result;
+  xSemaphoreTake(_sensorMutex, portMAX_DELAY);
+  bool ok = collect(&result);
+  _sensor->fillSample(sample, result);
+  xSemaphoreGive(_sensorMutex);
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Read and convert the pressure, see read()
+    @returns The pressure in the sensor's units, NAN on failure
+*/
+/**************************************************************************/
+float Adafruit_MPRLS_RTOS::readPressure(void) {
+  mprls_result_t result;
+  if (!read(&result))
+    return NAN;
+  return _sensor->convertRaw(result.raw);
+}
+
+/**************************************************************************/
+/*!
+    @brief Read the status byte without getting in the way of another
+   task's reading
+    @returns The status byte
+*/
+/**************************************************************************/
+uint8_t Adafruit_MPRLS_RTOS::readStatus(void) {
+  xSemaphoreTake(_sensorMutex, portMAX_DELAY);
+  xSemaphoreTake(_busMutex, portMAX_DELAY);
+  uint8_t status = _sensor->readStatus();
+  xSemaphoreGive(_busMutex);
+  xSemaphoreGive(_sensorMutex);
+  return status;
+}
+
+/**************************************************************************/
+/*!
+    @brief Start a conversion and wait for it, caller holds the sensor mutex
+    @returns True if the result is ready to fetch
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::convert(void) {
+  // drop a give left over from a conversion that timed out
+  if (_eocIRQ)
+    xSemaphoreTake(_ready, 0);
+
+  xSemaphoreTake(_busMutex, portMAX_DELAY);
+  bool ok = _sensor->startConversion();
+  xSemaphoreGive(_busMutex);
+  return ok && waitReady();
+}
+
+/**************************************************************************/
+/*!
+    @brief Run a conversion and fetch it, the sensor mutex must be held
+    @param result Filled in with the reading, error code and status byte
+    @returns True if the reading is valid
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::collect(mprls_result_t *result) {
+  bool ok = convert();
+  if (ok) {
+    xSemaphoreTake(_busMutex, portMAX_DELAY);
+    ok = _sensor->fetchResult(result);
+    xSemaphoreGive(_busMutex);
+  } else {
+    result->raw = 0xFFFFFFFF;
+    result->error = _sensor->lastError();
+    result->status = _sensor->lastStatus;
+  }
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Block until the conversion is done or has timed out. The bus is
+   only held for the status polls, so other tasks can use it meanwhile
+    @returns True if the result is ready to fetch
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::waitReady(void) {
+  if (_eocIRQ) {
+    // isReady() only checks the flag set by the interrupt
+    while (!_sensor->isReady()) {
+      xSemaphoreTake(_ready, usToTicks(_sensor->timeout()));
+      if (!_sensor->isReady() && _sensor->checkTimeout())
+        return false;
+    }
+    return true;
+  }
+
+  // nothing to tell us, so follow the sensor's polling strategy
+  sleepUs(_sensor->capWait(_sensor->_initialWait));
+  for (;;) {
+    xSemaphoreTake(_busMutex, portMAX_DELAY);
+    bool ready = _sensor->isReady();
+    xSemaphoreGive(_busMutex);
+    if (ready)
+      return true;
+    if (!_sensor->conversionPending() || _sensor->checkTimeout())
+      return false;
+    sleepUs(_sensor->capWait(_sensor->_pollInterval));
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Run readings in a task of their own and post every sample to a
+   queue. The task blocks between readings so it costs no CPU while waiting
+    @param queue Queue of mprls_sample_t, a full queue drops the sample
+    @param interval_ms Time between readings, 0 to convert back-to-back
+   (after a failed reading the task still waits out the sensor's timeout)
+    @param priority Task priority
+    @param core Core to pin the task to on ESP32, -1 for either; other ports
+   ignore this
+    @returns True if the task was created
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_RTOS::startSampler(QueueHandle_t queue,
+                                       uint32_t interval_ms,
+                                       UBaseType_t priority, BaseType_t core) {
+  if (_task || !queue || !_sensorMutex)
+    return false;
+
+  _queue = queue;
+  _interval = interval_ms ? msToTicks(interval_ms) : 0;
+  _stop = false;
+#if defined(ESP32)
+  BaseType_t ok = xTaskCreatePinnedToCore(
+      samplerTask, "mprls", MPRLS_SAMPLER_STACK, this, priority, &_task,
+      core < 0 ? tskNO_AFFINITY : core);
+#else
+  (void)core;
+  BaseType_t ok = xTaskCreate(samplerTask, "mprls", MPRLS_SAMPLER_STACK, this,
+                              priority, &_task);
+#endif
+  if (ok != pdPASS) {
+    _task = NULL;
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Stop the sampler task, waiting for its reading in flight to end.
+   Must not be called from the sampler task itself
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_RTOS::stopSampler(void) {
+  if (!_task)
+    return;
+  _stop = true;
+  while (_task)
+    vTaskDelay(1);
+}
+
+/**************************************************************************/
+/*!
+    @brief EOC callback, runs in the interrupt handler
+    @param arg The RTOS wrapper
+*/
+/**************************************************************************/
+MPRLS_ISR_ATTR void Adafruit_MPRLS_RTOS::eocGive(void *arg) {
+  Adafruit_MPRLS_RTOS *self = (Adafruit_MPRLS_RTOS *)arg;
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(self->_ready, &woken);
+#if defined(ESP32)
+  if (woken)
+    portYIELD_FROM_ISR();
+#else
+  portYIELD_FROM_ISR(woken);
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief Body of the sampler task
+    @param arg The RTOS wrapper
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_RTOS::samplerTask(void *arg) {
+  Adafruit_MPRLS_RTOS *self = (Adafruit_MPRLS_RTOS *)arg;
+  TickType_t last = xTaskGetTickCount();
+
+  while (!self->_stop) {
+    mprls_sample_t sample;
+    bool ok = self->readSample(&sample);
+    if (!ok)
+      self->_errors++;
+    else if (xQueueSend(self->_queue, &sample, 0) != pdTRUE)
+      self->_dropped++;
+    if (self->_interval)
+      vTaskDelayUntil(&last, self->_interval);
+    else if (!ok)
+      // an unhealthy sensor fails at once, don't starve the other tasks
+      vTaskDelay(usToTicks(self->_sensor->timeout()));
+  }
+
+  self->_task = NULL;
+  vTaskDelete(NULL);
+}
+
+#endif // MPRLS_HAS_FREERTOS
@@ -0,0 +1,100 @@
+/*!
+ * @file Adafruit_MPRLS_RTOS.h
+ *
+ * FreeRTOS integration for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_RTOS_H
+#define ADAFRUIT_MPRLS_RTOS_H
+
+#include "Adafruit_MPRLS.h"
+
+// ESP32 always runs FreeRTOS, other cores opt in
+#if defined(ESP32) || defined(MPRLS_USE_FREERTOS)
+#define MPRLS_HAS_FREERTOS ///< The RTOS integration is compiled in
+#endif
+
+#ifdef MPRLS_HAS_FREERTOS
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <FreeRTOS.h>
+#include <queue.h>
+#include <semphr.h>
+#include <task.h>
+#endif
+
+#define MPRLS_SAMPLER_STACK 2048 ///< Sampler stack, in the port's units
+
+/**************************************************************************/
+/*!
+    @brief  Task-safe access to a sensor under FreeRTOS. Every bus transfer
+   is made with the bus mutex held, so tasks sharing Wire can hand the same
+   mutex to their own drivers, and a second mutex keeps the write/wait/read
+   sequence of one sensor in one piece. The calling task blocks while the
+   sensor converts: on a semaphore given from the EOC interrupt when the
+   sensor has an EOC pin, otherwise in vTaskDelay() between status polls.
+   Either way the bus is free for other tasks during the conversion
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_RTOS {
+public:
+  Adafruit_MPRLS_RTOS(Adafruit_MPRLS *sensor,
+                      SemaphoreHandle_t busMutex = NULL);
+  ~Adafruit_MPRLS_RTOS(void);
+
+  bool begin(uint8_t i2c_addr = MPRLS_DEFAULT_ADDR, TwoWire *twoWire = &Wire);
+  bool read(mprls_result_t *result);
+  bool readSample(mprls_sample_t *sample);
+  float readPressure(void);
+  uint8_t readStatus(void);
+
+  /*! @brief The mutex guarding the bus, for other drivers on the same bus
+   * @returns The mutex, NULL before begin() */
+  SemaphoreHandle_t busMutex(void) { return _busMutex; }
+
+  bool startSampler(QueueHandle_t queue, uint32_t interval_ms,
+                    UBaseType_t priority = 1, BaseType_t core = -1);
+  void stopSampler(void);
+  /*! @brief Samples lost because the queue was full @returns Count */
+  uint32_t dropped(void) { return _dropped; }
+  /*! @brief Sampler reads that failed @returns Count */
+  uint32_t errors(void) { return _errors; }
+
+private:
+  Adafruit_MPRLS *_sensor;
+  SemaphoreHandle_t _busMutex;
+  bool _ownBusMutex = false;             ///< _busMutex was created here
+  SemaphoreHandle_t _sensorMutex = NULL; ///< Serialises whole reads
+  SemaphoreHandle_t _ready = NULL;       ///< Given by the EOC interrupt
+  bool _eocIRQ = false;                  ///< EOC interrupt is in use
+
+  TaskHandle_t _task = NULL;
+  QueueHandle_t _queue = NULL;
+  TickType_t _interval = 0;
+  volatile bool _stop = false;
+  volatile uint32_t _dropped = 0;
+  volatile uint32_t _errors = 0;
+
+  bool convert(void);
+  bool collect(mprls_result_t *result);
+  bool waitReady(void);
+  static void eocGive(void *arg);
+  static void samplerTask(void *arg);
+};
+
+#endif // MPRLS_HAS_FREERTOS
+
+#endif
@@ -0,0 +1,91 @@
+/*!
+ * @file Adafruit_MPRLS_Recovery.cpp
+ *
+ * Automatic error recovery for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Recovery.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param sensor The sensor to look after, begin() or beginAsync() must
+   have been called so the bus is set up
+    @param min_backoff_ms Wait after the first failed try
+    @param max_backoff_ms Longest wait, the wait doubles until it gets here
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Recovery::Adafruit_MPRLS_Recovery(Adafruit_MPRLS_Base *sensor,
+                                                 uint32_t min_backoff_ms,
+                                                 uint32_t max_backoff_ms) {
+  _sensor = sensor;
+  _minBackoff = min_backoff_ms;
+  _maxBackoff = max_backoff_ms < min_backoff_ms ? min_backoff_ms
+                                                : max_backoff_ms;
+  _backoff = _minBackoff;
+}
+
+/**************************************************************************/
+/*!
+    @brief Advance the recovery, never blocks. Starts a reset as soon as the
+   sensor is found unhealthy
+    @returns Where the recovery is now
+*/
+/**************************************************************************/
+mprls_recovery_t Adafruit_MPRLS_Recovery::service(void) {
+  switch (_state) {
+  case MPRLS_RECOVERY_HEALTHY:
+    if (_sensor->isHealthy())
+      return _state;
+    break;
+
+  case MPRLS_RECOVERY_BACKOFF:
+    // probe() or begin() may have brought it back meanwhile, don't reset a
+    // working sensor
+    if (_sensor->isHealthy())
+      return recovered();
+    if (millis() - _backoffStart < _backoff)
+      return _state;
+    break;
+
+  case MPRLS_RECOVERY_RESETTING:
+    switch (_sensor->pollBegin()) {
+    case MPRLS_BEGIN_PENDING:
+      return _state;
+    case MPRLS_BEGIN_OK:
+      return recovered();
+    default:
+      if (_attempts < 0xFFFF)
+        _attempts++;
+      _backoffStart = millis();
+      return _state = MPRLS_RECOVERY_BACKOFF;
+    }
+  }
+
+  // time for a (new) try, the wait after it fails doubles
+  if (_state == MPRLS_RECOVERY_BACKOFF)
+    _backoff = _backoff < _maxBackoff / 2 ? _backoff * 2 : _maxBackoff;
+  _sensor->resetAsync();
+  return _state = MPRLS_RECOVERY_RESETTING;
+}
+
+/**************************************************************************/
+/*!
+    @brief Note that the sensor is back and start over with the shortest wait
+    @returns MPRLS_RECOVERY_HEALTHY
+*/
+/**************************************************************************/
+mprls_recovery_t Adafruit_MPRLS_Recovery::recovered(void) {
+  _recoveries++;
+  _attempts = 0;
+  _backoff = _minBackoff;
+  return _state = MPRLS_RECOVERY_HEALTHY;
+}
@@ -0,0 +1,68 @@
+/*!
+ * @file Adafruit_MPRLS_Recovery.h
+ *
+ * Automatic error recovery for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_RECOVERY_H
+#define ADAFRUIT_MPRLS_RECOVERY_H
+
+#include "Adafruit_MPRLS.h"
+
+#define MPRLS_RECOVERY_MIN_BACKOFF_MS 10    ///< Wait after the first failure
+#define MPRLS_RECOVERY_MAX_BACKOFF_MS 10000 ///< Longest wait between tries
+
+/** Where a sensor is in its recovery */
+typedef enum {
+  MPRLS_RECOVERY_HEALTHY,   ///< Working, nothing to do
+  MPRLS_RECOVERY_RESETTING, ///< Reset pulse or startup wait in progress
+  MPRLS_RECOVERY_BACKOFF,   ///< Last try failed, waiting to try again
+} mprls_recovery_t;
+
+/**************************************************************************/
+/*!
+    @brief  Brings a sensor back once it has been marked unhealthy (see
+   Adafruit_MPRLS::setFailureThreshold()) without blocking: the reset pin is
+   pulsed if one is wired, the powered status is checked once the startup
+   time has passed and failed tries are repeated with exponential backoff.
+   Call service() from loop(); Adafruit_MPRLS_Manager does this for its
+   sensors given setRecovery()
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Recovery {
+public:
+  Adafruit_MPRLS_Recovery(
+      Adafruit_MPRLS_Base *sensor,
+      uint32_t min_backoff_ms = MPRLS_RECOVERY_MIN_BACKOFF_MS,
+      uint32_t max_backoff_ms = MPRLS_RECOVERY_MAX_BACKOFF_MS);
+
+  mprls_recovery_t service(void);
+  /*! @brief The state after the last service() @returns The state */
+  mprls_recovery_t state(void) { return _state; }
+
+  /*! @brief Failed tries since the sensor was last healthy @returns Count */
+  uint16_t attempts(void) { return _attempts; }
+  /*! @brief Times the sensor was brought back @returns Count */
+  uint32_t recoveries(void) { return _recoveries; }
+
+private:
+  Adafruit_MPRLS_Base *_sensor;
+  uint32_t _minBackoff, _maxBackoff;
+  uint32_t _backoff; ///< Wait before the next try, ms
+  uint32_t _backoffStart = 0;
+  mprls_recovery_t _state = MPRLS_RECOVERY_HEALTHY;
+  uint16_t _attempts = 0;
+  uint32_t _recoveries = 0;
+
+  mprls_recovery_t recovered(void);
+};
+
+#endif
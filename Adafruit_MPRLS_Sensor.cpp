@@ -0,0 +1,79 @@
+/*!
+ * @file Adafruit_MPRLS_Sensor.cpp
+ *
+ * Adafruit Unified Sensor interface for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Sensor.h"
+
+/**************************************************************************/
+/*!
+    @brief  Gets the pressure as a standard sensor event
+    @param  event Sensor event object that will be populated
+    @returns True on success, False if the read failed
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Pressure::getEvent(sensors_event_t *event) {
+  mprls_result_t result;
+
+  // someone may already have started one, finish it rather than start
+  // another
+  if (_theMPRLS->conversionPending())
+    result = _theMPRLS->finishConversion();
+  else
+    result = _theMPRLS->readResult();
+
+  if (result.error != MPRLS_OK)
+    return false;
+
+  memset(event, 0, sizeof(sensors_event_t));
+  event->version = sizeof(sensors_event_t);
+  event->sensor_id = _sensorID;
+  event->type = SENSOR_TYPE_PRESSURE;
+  event->timestamp = millis();
+  event->pressure = toHPA(_theMPRLS->convertRaw(result.raw));
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the sensor_t data for the pressure sensor
+    @param  sensor Sensor description that will be populated
+*/
+/**************************************************************************/
+void Adafruit_MPRLS_Pressure::getSensor(sensor_t *sensor) {
+  memset(sensor, 0, sizeof(sensor_t));
+
+  strncpy(sensor->name, "MPRLS", sizeof(sensor->name) - 1);
+  sensor->version = 1;
+  sensor->sensor_id = _sensorID;
+  sensor->type = SENSOR_TYPE_PRESSURE;
+  sensor->min_delay = MPRLS_CONVERSION_TIME_US;
+  sensor->min_value = _theMPRLS->_PSI_min * PSI_to_HPA;
+  sensor->max_value = _theMPRLS->_PSI_max * PSI_to_HPA;
+  sensor->resolution = fabs(toHPA(_theMPRLS->_gain));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert from the units the sensor was set up with to hPa
+    @param  value Pressure (or pressure difference) in the sensor's units
+    @returns The value in hPa
+*/
+/**************************************************************************/
+float Adafruit_MPRLS_Pressure::toHPA(float value) {
+  float k = _theMPRLS->_K;
+
+  // the default, skip the extra conversion
+  if (k == (float)PSI_to_HPA)
+    return value;
+  return value * (float)PSI_to_HPA / k;
+}
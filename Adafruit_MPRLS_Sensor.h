@@ -0,0 +1,50 @@
+/*!
+ * @file Adafruit_MPRLS_Sensor.h
+ *
+ * Adafruit Unified Sensor interface for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_SENSOR_H
+#define ADAFRUIT_MPRLS_SENSOR_H
+
+#include "Adafruit_MPRLS.h"
+#include <Adafruit_Sensor.h>
+
+/**************************************************************************/
+/*!
+    @brief  Adafruit Unified Sensor interface for the pressure of an MPRLS.
+   Events are filled in place in hPa whatever units the sensor was set up
+   with, and conversions already started with startConversion() are picked
+   up instead of starting a new one
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Pressure : public Adafruit_Sensor {
+public:
+  /*!
+      @brief constructor
+      @param parent The sensor to read, begin() must be called on it
+      @param sensorID Unique ID reported in events
+  */
+  Adafruit_MPRLS_Pressure(Adafruit_MPRLS *parent, int32_t sensorID = 3965) {
+    _theMPRLS = parent;
+    _sensorID = sensorID;
+  }
+  bool getEvent(sensors_event_t *event);
+  void getSensor(sensor_t *sensor);
+
+private:
+  Adafruit_MPRLS *_theMPRLS = NULL;
+  int32_t _sensorID = 0;
+
+  float toHPA(float value);
+};
+
+#endif
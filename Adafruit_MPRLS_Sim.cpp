@@ -0,0 +1,119 @@
+/*!
+ * @file Adafruit_MPRLS_Sim.cpp
+ *
+ * Simulated MPRLS sensor for the Adafruit MPRLS library
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_MPRLS_Sim.h"
+
+/**************************************************************************/
+/*!
+    @brief constructor
+    @param conversion_us How long a conversion stays busy, in microseconds
+*/
+/**************************************************************************/
+Adafruit_MPRLS_Sim::Adafruit_MPRLS_Sim(uint32_t conversion_us) {
+  _convTime = conversion_us;
+}
+
+/**************************************************************************/
+/*!
+    @brief Answers like a sensor that is present, unless NACKing
+    @returns True if the sensor "answered"
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Sim::begin(void) {
+  _converting = false;
+  return !nacked();
+}
+
+/**************************************************************************/
+/*!
+    @brief Read the status byte and, for longer reads, the result
+    @param buffer Where to put the data
+    @param len Number of bytes to read
+    @returns True unless NACKing
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Sim::read(uint8_t *buffer, size_t len) {
+  _reads++;
+  if (nacked())
+    return false;
+
+  uint8_t status = MPRLS_STATUS_POWERED;
+  if (!eoc())
+    status |= MPRLS_STATUS_BUSY;
+  else if (_conversions)
+    status |= _flags;
+
+  for (size_t i = 0; i < len; i++) {
+    switch (i) {
+    case 0:
+      buffer[i] = status;
+      break;
+    case 1:
+    case 2:
+    case 3:
+      buffer[i] = _raw >> (8 * (3 - i));
+      break;
+    default:
+      buffer[i] = 0;
+    }
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Take a command, 0xAA starts a conversion
+    @param buffer The data sent
+    @param len Number of bytes
+    @returns True unless NACKing
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Sim::write(const uint8_t *buffer, size_t len) {
+  _writes++;
+  if (nacked())
+    return false;
+
+  if (len && buffer[0] == 0xAA) {
+    _convStart = micros();
+    _converting = true;
+    _conversions++;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Level the EOC pin would have, for driving an EOC model
+    @returns True once the conversion in flight is done
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Sim::eoc(void) {
+  if (_converting && micros() - _convStart >= _convTime)
+    _converting = false;
+  return !_converting;
+}
+
+/**************************************************************************/
+/*!
+    @brief Use up one injected NACK
+    @returns True if this transfer should fail
+*/
+/**************************************************************************/
+bool Adafruit_MPRLS_Sim::nacked(void) {
+  if (!_nacks)
+    return false;
+  if (_nacks != 0xFF)
+    _nacks--;
+  return true;
+}
@@ -0,0 +1,79 @@
+/*!
+ * @file Adafruit_MPRLS_Sim.h
+ *
+ * Simulated MPRLS sensor for the Adafruit MPRLS library
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_SIM_H
+#define ADAFRUIT_MPRLS_SIM_H
+
+#include "Adafruit_MPRLS.h"
+
+/**************************************************************************/
+/*!
+    @brief  Transport that is a simulated sensor instead of a bus, so the
+   library can be exercised and timed without hardware. It follows the real
+   command/status protocol: the 0xAA command starts a conversion that stays
+   busy for the conversion time (measured with micros()), then the status
+   byte reads powered with the 24 bit result behind it. Status faults and
+   NACKs can be injected. Give the sensor any EOC pin number to have it
+   watch the model's EOC line instead of polling status
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Sim : public Adafruit_MPRLS_Transport {
+public:
+  Adafruit_MPRLS_Sim(uint32_t conversion_us = MPRLS_CONVERSION_TIME_US);
+
+  bool begin(void);
+  bool read(uint8_t *buffer, size_t len);
+  bool write(const uint8_t *buffer, size_t len);
+
+  /*! @brief Set what the following conversions measure
+   * @param raw 24 bit reading */
+  void setRaw(uint32_t raw) { _raw = raw & 0xFFFFFF; }
+  /*! @brief Set how long a conversion stays busy
+   * @param conversion_us Conversion time in microseconds */
+  void setConversionTime(uint32_t conversion_us) { _convTime = conversion_us; }
+  /*! @brief Report status bits with every finished conversion
+   * @param flags e.g. MPRLS_STATUS_MATHSAT or MPRLS_STATUS_FAILED, 0 to
+   * clear */
+  void setStatusFlags(uint8_t flags) { _flags = flags; }
+  /*! @brief Make the next transfers fail as if the sensor didn't answer
+   * @param transfers Number of transfers to NACK, 0xFF for all */
+  void nack(uint8_t transfers) { _nacks = transfers; }
+  bool eoc(void);
+  /*! @brief Drive the sensor's EOC from the model, see eoc()
+   * @returns 1 once the conversion is done, 0 while busy */
+  int8_t eocLevel(void) { return eoc() ? 1 : 0; }
+
+  /*! @brief Read transfers seen @returns Count */
+  uint32_t reads(void) { return _reads; }
+  /*! @brief Write transfers seen @returns Count */
+  uint32_t writes(void) { return _writes; }
+  /*! @brief Conversions started @returns Count */
+  uint32_t conversions(void) { return _conversions; }
+
+private:
+  uint32_t _raw = 0x800000; ///< Half scale
+  uint32_t _convTime;
+  uint32_t _convStart = 0;
+  bool _converting = false;
+  uint8_t _flags = 0;
+  uint8_t _nacks = 0;
+
+  uint32_t _reads = 0;
+  uint32_t _writes = 0;
+  uint32_t _conversions = 0;
+
+  bool nacked(void);
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*!
+ * @file Adafruit_MPRLS_Transport.h
+ *
+ * Pluggable bus transport for the MPRLS sensors from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_MPRLS_TRANSPORT_H
+#define ADAFRUIT_MPRLS_TRANSPORT_H
+
+#if (ARDUINO >= 100)
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+/** Called when an asynchronous transfer finishes, possibly from an ISR */
+typedef void (*MPRLS_TransferCallback)(bool ok, void *arg);
+
+/**************************************************************************/
+/*!
+    @brief  Interface between Adafruit_MPRLS and the bus. Without one the
+   sensor talks through its own Adafruit_I2CDevice; a transport lets a sketch
+   or a core-specific backend (DMA or interrupt driven I2C) take over. The
+   asynchronous calls fall back to the blocking ones, so a backend only needs
+   to override what its core can really do in the background
+*/
+/**************************************************************************/
+class Adafruit_MPRLS_Transport {
+public:
+  virtual ~Adafruit_MPRLS_Transport() {}
+
+  /*!
+      @brief Set up the bus and check the sensor answers, called by begin()
+      @returns True if the sensor was found
+  */
+  virtual bool begin(void) { return true; }
+
+  /*!
+      @brief Blocking read
+      @param buffer Where to put the data
+      @param len Number of bytes to read
+      @returns True on success
+  */
+  virtual bool read(uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief Blocking write
+      @param buffer The data to send
+      @param len Number of bytes to write
+      @returns True on success
+  */
+  virtual bool write(const uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief Start a read that completes in the background
+      @param buffer Where to put the data, must stay valid until the callback
+      @param len Number of bytes to read
+      @param callback Called with the outcome once the read is done
+      @param arg Pointer passed through to the callback
+      @returns True if the read was started, the callback then reports how
+     it went (possibly before this returns). False if it could not be
+     started, the callback is not called then
+  */
+  virtual bool readAsync(uint8_t *buffer, size_t len,
+                         MPRLS_TransferCallback callback, void *arg) {
+    bool ok = read(buffer, len);
+    if (callback)
+      callback(ok, arg);
+    return true;
+  }
+
+  /*!
+      @brief Start a write that completes in the background
+      @param buffer The data to send, must stay valid until the callback
+      @param len Number of bytes to write
+      @param callback Called with the outcome once the write is done
+      @param arg Pointer passed through to the callback
+      @returns True if the write was started, see readAsync()
+  */
+  virtual bool writeAsync(const uint8_t *buffer, size_t len,
+                          MPRLS_TransferCallback callback, void *arg) {
+    bool ok = write(buffer, len);
+    if (callback)
+      callback(ok, arg);
+    return true;
+  }
+
+  /*!
+      @brief Check for a background transfer still in progress
+      @returns True while the bus is busy with an asynchronous transfer
+  */
+  virtual bool busy(void) { return false; }
+
+  /*!
+      @brief Level of the EOC line, for backends that drive it themselves.
+     The sensor still needs an EOC pin number to use EOC mode, but then reads
+     it here instead of with digitalRead()
+      @returns 1 high, 0 low, -1 if the sensor should read its pin
+  */
+  virtual int8_t eocLevel(void) { return -1; }
+};
+
+#endif
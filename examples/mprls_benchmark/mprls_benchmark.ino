@@ -0,0 +1,319 @@
+/*!
+ * @file mprls_benchmark.ino
+ *
+ * Measures how each read mode of the library performs, so read modes, bus
+ * speeds and library versions can be compared
+ *
+ * Designed specifically to work with the MPRLS sensor from Adafruit
+ * ----> https://www.adafruit.com/products/3965
+ *
+ * For every read mode and bus clock one CSV line is printed:
+ *   mode,sensors,clock_hz,samples,errors,sps,lat_min_us,lat_p50_us,
+ *   lat_p95_us,lat_max_us,idle_pct,i2c_per_sample
+ * sps is samples per second, lat_* the time from starting a conversion to
+ * having its result (the time between samples for "continuous"), idle_pct
+ * the share of the run the CPU could have spent elsewhere and
+ * i2c_per_sample the bus transactions needed per sample. Lines starting
+ * with # are comments, among them the CPU cost of the float and fixed point
+ * conversions (in cycles where the core defines F_CPU)
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include <Wire.h>
+#include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Continuous.h"
+#include "Adafruit_MPRLS_Manager.h"
+
+#define RESET_PIN  -1   // set to any GPIO pin # to hard-reset on begin()
+#define EOC_PIN    -1   // set to an interrupt capable pin to bench EOC modes
+#define SENSOR_COUNT 1  // more than 1 needs a TCA9548A, sensor n on channel n
+#define TCA_ADDR   0x70 // TCA9548A address
+#define SAMPLES    64   // samples per mode
+#define WORK_US    250  // application work between polls in non-blocking modes
+
+/** Adafruit_I2CDevice with a transaction counter, for i2c_per_sample */
+class CountingTransport : public Adafruit_MPRLS_Transport {
+public:
+  bool begin(void) { return dev.begin(); }
+  bool read(uint8_t *buffer, size_t len) {
+    transfers++;
+    return dev.read(buffer, len);
+  }
+  bool write(const uint8_t *buffer, size_t len) {
+    transfers++;
+    return dev.write(buffer, len);
+  }
+
+  Adafruit_I2CDevice dev{MPRLS_DEFAULT_ADDR, &Wire};
+  uint32_t transfers = 0;
+};
+
+Adafruit_MPRLS sensors[SENSOR_COUNT] = {Adafruit_MPRLS(RESET_PIN, EOC_PIN)};
+CountingTransport transports[SENSOR_COUNT];
+const uint32_t clocks[] = {100000, 400000};
+
+uint32_t latency[SAMPLES];
+uint16_t count, errors;
+uint32_t slept; // time the library offered to sleep through, us
+uint32_t runStart, runBusy;
+
+void selectChannel(uint8_t channel, void *) {
+  Wire.beginTransmission(TCA_ADDR);
+  Wire.write(1 << channel);
+  Wire.endTransmission();
+}
+
+// stands in for the application's own work in the non-blocking modes
+void work(void) { delayMicroseconds(WORK_US); }
+
+// stands in for a real sleep, the time could have gone to other work
+void countSleep(uint32_t us, void *) {
+  slept += us;
+  delayMicroseconds(us);
+}
+
+uint32_t transfers(uint8_t sensors) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < sensors; i++)
+    total += transports[i].transfers;
+  return total;
+}
+
+void startRun(void) {
+  count = errors = 0;
+  slept = runBusy = 0;
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+    transports[i].transfers = 0;
+  runStart = micros();
+}
+
+void record(uint32_t us, bool ok) {
+  if (!ok)
+    errors++;
+  if (count < SAMPLES)
+    latency[count++] = us;
+}
+
+void report(const char *mode, uint8_t sensors, uint32_t clock,
+            uint16_t samples, uint32_t idle) {
+  uint32_t elapsed = micros() - runStart;
+
+  // insertion sort, a handful of samples
+  for (uint16_t i = 1; i < count; i++) {
+    uint32_t v = latency[i];
+    uint16_t j = i;
+    for (; j > 0 && latency[j - 1] > v; j--)
+      latency[j] = latency[j - 1];
+    latency[j] = v;
+  }
+
+  Serial.print(mode);
+  Serial.print(',');
+  Serial.print(sensors);
+  Serial.print(',');
+  Serial.print(clock);
+  Serial.print(',');
+  Serial.print(samples);
+  Serial.print(',');
+  Serial.print(errors);
+  Serial.print(',');
+  Serial.print(samples * 1e6 / elapsed, 1);
+  Serial.print(',');
+  Serial.print(count ? latency[0] : 0);
+  Serial.print(',');
+  Serial.print(count ? latency[count / 2] : 0);
+  Serial.print(',');
+  Serial.print(count ? latency[(count * 95) / 100] : 0);
+  Serial.print(',');
+  Serial.print(count ? latency[count - 1] : 0);
+  Serial.print(',');
+  Serial.print(idle * 100.0 / elapsed, 1);
+  Serial.print(',');
+  Serial.println((float)transfers(sensors) / samples, 2);
+}
+
+// readResult() with the library's default polling strategy
+void benchBlocking(const char *mode, uint32_t clock) {
+  Adafruit_MPRLS &mpr = sensors[0];
+  startRun();
+  for (uint16_t i = 0; i < SAMPLES; i++) {
+    uint32_t t = micros();
+    mprls_result_t r = mpr.readResult();
+    record(micros() - t, r.error == MPRLS_OK);
+  }
+  report(mode, 1, clock, SAMPLES, slept);
+}
+
+// startConversion()/isReady()/fetchResult(), the caller works in between
+void benchSplit(uint32_t clock) {
+  Adafruit_MPRLS &mpr = sensors[0];
+  startRun();
+  for (uint16_t i = 0; i < SAMPLES; i++) {
+    uint32_t start = micros();
+    bool ok = mpr.startConversion();
+    runBusy += micros() - start;
+    while (ok) {
+      uint32_t t = micros();
+      bool ready =
+          mpr.isReady() || !mpr.conversionPending() || mpr.checkTimeout();
+      runBusy += micros() - t;
+      if (ready)
+        break;
+      work();
+    }
+    uint32_t t = micros();
+    mprls_result_t r;
+    ok = ok && mpr.conversionPending() && mpr.fetchResult(&r);
+    uint32_t done = micros();
+    runBusy += done - t;
+    record(done - start, ok);
+  }
+  report("split", 1, clock, SAMPLES, micros() - runStart - runBusy);
+}
+
+// the continuous engine converting back-to-back, serviced between work
+void benchContinuous(uint32_t clock) {
+  mprls_sample_t storage[8];
+  Adafruit_MPRLS_SampleQueue queue(storage, 8);
+  Adafruit_MPRLS_Continuous engine(&sensors[0], &queue);
+  uint32_t last = 0;
+
+  startRun();
+  engine.start();
+  while (count < SAMPLES && micros() - runStart < SAMPLES * 50000UL) {
+    uint32_t t = micros();
+    engine.service();
+    runBusy += micros() - t;
+
+    mprls_sample_t sample;
+    while (queue.pop(&sample)) {
+      if (last)
+        record(sample.timestamp - last, true);
+      last = sample.timestamp;
+    }
+    work();
+  }
+  engine.stop();
+  errors = engine.errors() + engine.dropped();
+  report("continuous", 1, clock, count, micros() - runStart - runBusy);
+}
+
+// overlapped sweeps over 1..n sensors
+void benchManager(uint8_t n, uint32_t clock) {
+  Adafruit_MPRLS_Manager manager;
+  manager.setSelectCallback(selectChannel);
+  for (uint8_t i = 0; i < n; i++)
+    manager.addSensor(&sensors[i], i);
+
+  uint16_t sweeps = SAMPLES / n;
+  startRun();
+  for (uint16_t i = 0; i < sweeps; i++) {
+    uint32_t t = micros();
+    uint8_t ok = manager.readAll();
+    uint32_t us = micros() - t;
+    for (uint8_t s = 0; s < n; s++)
+      record(us, s < ok);
+  }
+  report("manager", n, clock, sweeps * n, slept);
+}
+
+// CPU cost of one conversion, either in cycles or in ns
+void printCost(const char *name, uint32_t us, uint16_t n) {
+  Serial.print("# ");
+  Serial.print(name);
+#ifdef F_CPU
+  Serial.print(" cycles/op ");
+  Serial.println((float)us * (F_CPU / 1000000UL) / n, 1);
+#else
+  Serial.print(" ns/op ");
+  Serial.println(us * 1000.0 / n, 1);
+#endif
+}
+
+// float against fixed point conversion, the loop overhead is in both
+void benchConvert(void) {
+  const uint16_t n = 1000;
+  Adafruit_MPRLS &mpr = sensors[0];
+  volatile float pressure;
+  volatile int32_t fixed;
+
+  uint32_t t = micros();
+  for (uint16_t i = 0; i < n; i++)
+    pressure = mpr.convertRaw(0x800000UL + i);
+  printCost("convertRaw", micros() - t, n);
+
+  t = micros();
+  for (uint16_t i = 0; i < n; i++)
+    fixed = mpr.convertRawFixed(0x800000UL + i);
+  printCost("convertRawFixed", micros() - t, n);
+  (void)pressure;
+  (void)fixed;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10);
+  Wire.begin();
+
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+    if (SENSOR_COUNT > 1)
+      selectChannel(i, NULL);
+    sensors[i].setTransport(&transports[i]);
+    sensors[i].setSleepCallback(countSleep);
+    if (!sensors[i].begin()) {
+      Serial.print("# sensor ");
+      Serial.print(i);
+      Serial.println(" not found, check wiring?");
+      while (1)
+        delay(10);
+    }
+  }
+  Serial.println("# mprls_benchmark 1");
+  Serial.println("mode,sensors,clock_hz,samples,errors,sps,lat_min_us,"
+                 "lat_p50_us,lat_p95_us,lat_max_us,idle_pct,i2c_per_sample");
+}
+
+void loop() {
+  Adafruit_MPRLS &mpr = sensors[0];
+  if (SENSOR_COUNT > 1)
+    selectChannel(0, NULL);
+
+  benchConvert();
+  for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+    Wire.setClock(clocks[c]);
+
+    mpr.setPollingStrategy(0, 0); // status polls back-to-back
+    benchBlocking("poll_spin", clocks[c]);
+    mpr.setPollingStrategy();
+    benchBlocking("poll", clocks[c]);
+    mpr.setMergedRead(true);
+    benchBlocking("poll_merged", clocks[c]);
+    mpr.setMergedRead(false);
+
+    if (EOC_PIN >= 0) {
+      benchBlocking("eoc_pin", clocks[c]);
+      if (mpr.enableEOCInterrupt()) {
+        benchBlocking("eoc_irq", clocks[c]);
+        benchSplit(clocks[c]);
+        mpr.disableEOCInterrupt();
+      }
+    } else {
+      benchSplit(clocks[c]);
+    }
+    benchContinuous(clocks[c]);
+
+    for (uint8_t n = 1; n <= SENSOR_COUNT; n++)
+      benchManager(n, clocks[c]);
+  }
+
+  Serial.println("# done");
+  while (1)
+    delay(10);
+}
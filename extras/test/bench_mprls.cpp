@@ -0,0 +1,96 @@
+/*!
+ * @file bench_mprls.cpp
+ *
+ * Host microbenchmarks for the MPRLS library hot paths. The numbers are
+ * host CPU time, useful to compare changes rather than to predict what a
+ * microcontroller does; the bus transfer counts per reading carry over
+ * directly.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include <chrono>
+#include <stdio.h>
+
+#include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Alarm.h"
+#include "Adafruit_MPRLS_Continuous.h"
+#include "Adafruit_MPRLS_Filter.h"
+#include "Adafruit_MPRLS_Sim.h"
+
+static const uint32_t ITERATIONS = 1000000;
+static volatile uint32_t sink; // keeps the results alive
+
+typedef Adafruit_MPRLS_T<0, 25> MPRLS_25PSI; ///< Compile-time default part
+
+/** Time a loop body and print ns per iteration */
+#define BENCH(name, iterations, body)                                          \
+  do {                                                                         \
+    auto start = std::chrono::steady_clock::now();                             \
+    for (uint32_t i = 0; i < (iterations); i++) {                              \
+      body;                                                                    \
+    }                                                                          \
+    std::chrono::duration<double, std::nano> took =                            \
+        std::chrono::steady_clock::now() - start;                              \
+    printf("%-28s %8.2f ns/op\n", name, took.count() / (iterations));          \
+  } while (0)
+
+static void benchReads(const char *name, Adafruit_MPRLS_Sim *sim,
+                       Adafruit_MPRLS *mprls) {
+  const uint32_t samples = 10000;
+  uint32_t reads = sim->reads(), writes = sim->writes();
+  BENCH(name, samples, sink = mprls->readResult().raw);
+  printf("%-28s %8.2f transfers/read\n", "",
+         (double)(sim->reads() - reads + sim->writes() - writes) / samples);
+}
+
+int main(void) {
+  Adafruit_MPRLS mprls;
+  const uint32_t mask = 0xFFFFF;
+
+  BENCH("convertRaw", ITERATIONS, sink = (uint32_t)mprls.convertRaw(i & mask));
+  BENCH("convertRawFixed", ITERATIONS, sink = mprls.convertRawFixed(i & mask));
+  BENCH("Adafruit_MPRLS_T::convertRaw", ITERATIONS,
+        sink = (uint32_t)MPRLS_25PSI::convertRaw(i & mask));
+
+  float pressure[256];
+  uint32_t raw[256];
+  for (uint16_t i = 0; i < 256; i++)
+    raw[i] = 0x800000 + i;
+  BENCH("convertRaw, 256 per call", ITERATIONS / 256,
+        mprls.convertRaw(raw, pressure, 256));
+  sink = (uint32_t)pressure[255];
+
+  Adafruit_MPRLS_Filter filter;
+  filter.setMedianWindow(5);
+  filter.setEMA(0.25);
+  BENCH("filter median5+EMA", ITERATIONS, sink = filter.process(i & mask));
+
+  mprls_sample_t storage[64], sample = {0, 0, 0, 0};
+  Adafruit_MPRLS_SampleQueue queue(storage, 64);
+  BENCH("queue push+pop", ITERATIONS,
+        (queue.push(sample), queue.pop(&sample)));
+  sink = sample.raw;
+
+  Adafruit_MPRLS_Alarm alarm(&mprls);
+  alarm.setHigh(1000, 10);
+  alarm.setLow(100, 10);
+  alarm.setRate(500);
+  BENCH("alarm check", ITERATIONS, sink = alarm.check(i & mask, i * 1000));
+
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS polled;
+  polled.setTransport(&sim);
+  polled.begin();
+  benchReads("readResult, status polls", &sim, &polled);
+  polled.setMergedRead(true);
+  benchReads("readResult, merged polls", &sim, &polled);
+
+  Adafruit_MPRLS_Sim eocSim;
+  Adafruit_MPRLS eoc(-1, 5);
+  eoc.setTransport(&eocSim);
+  eoc.begin();
+  benchReads("readResult, EOC", &eocSim, &eoc);
+  return 0;
+}
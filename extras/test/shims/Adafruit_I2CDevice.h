@@ -0,0 +1,52 @@
+/*!
+ * @file Adafruit_I2CDevice.h
+ *
+ * Host stand-in for the BusIO I2C device: there is no bus, so nothing ever
+ * answers
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef MPRLS_HOST_I2CDEVICE_H
+#define MPRLS_HOST_I2CDEVICE_H
+
+#include "Wire.h"
+
+/**************************************************************************/
+/*!
+    @brief  I2C device that is never found
+*/
+/**************************************************************************/
+class Adafruit_I2CDevice {
+public:
+  /*! @brief constructor @param addr Address @param theWire Bus */
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire) {
+    (void)addr;
+    (void)theWire;
+  }
+  /*! @brief Look for the device @param addr_detect Ignored
+   * @returns False, nothing is there */
+  bool begin(bool addr_detect = true) {
+    (void)addr_detect;
+    return false;
+  }
+  /*! @brief Read @param buffer Ignored @param len Ignored @param stop Ignored
+   * @returns False, NACK */
+  bool read(uint8_t *buffer, size_t len, bool stop = true) {
+    (void)buffer;
+    (void)len;
+    (void)stop;
+    return false;
+  }
+  /*! @brief Write @param buffer Ignored @param len Ignored @param stop Ignored
+   * @returns False, NACK */
+  bool write(const uint8_t *buffer, size_t len, bool stop = true) {
+    (void)buffer;
+    (void)len;
+    (void)stop;
+    return false;
+  }
+};
+
+#endif
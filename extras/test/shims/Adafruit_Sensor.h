@@ -0,0 +1,57 @@
+/*!
+ * @file Adafruit_Sensor.h
+ *
+ * The parts of the Adafruit Unified Sensor interface the MPRLS library uses,
+ * for host builds
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef MPRLS_HOST_SENSOR_H
+#define MPRLS_HOST_SENSOR_H
+
+#include "Arduino.h"
+
+#define SENSOR_TYPE_PRESSURE (6) ///< Pressure sensor type
+
+/** Sensor event, trimmed to what a pressure sensor fills in */
+typedef struct {
+  int32_t version;   ///< sizeof(sensors_event_t)
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< Sensor type
+  int32_t reserved0; ///< Reserved
+  int32_t timestamp; ///< millis() of the event
+  union {
+    float data[4];  ///< Raw storage
+    float pressure; ///< Pressure in hPa
+  };
+} sensors_event_t;
+
+/** Sensor details */
+typedef struct {
+  char name[12];     ///< Sensor name
+  int32_t version;   ///< Driver version
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< Sensor type
+  float max_value;   ///< Largest value reported
+  float min_value;   ///< Smallest value reported
+  float resolution;  ///< Smallest step
+  int32_t min_delay; ///< Microseconds between events
+} sensor_t;
+
+/**************************************************************************/
+/*!
+    @brief  Unified sensor interface
+*/
+/**************************************************************************/
+class Adafruit_Sensor {
+public:
+  virtual ~Adafruit_Sensor() {}
+  /*! @brief Read an event @param event Filled in @returns True on success */
+  virtual bool getEvent(sensors_event_t *event) = 0;
+  /*! @brief Describe the sensor @param sensor Filled in */
+  virtual void getSensor(sensor_t *sensor) = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*!
+ * @file Arduino.cpp
+ *
+ * Simulated clock and pins behind the host Arduino shim
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+TwoWire Wire;
+
+static uint64_t hostMicros = 0; ///< Simulated time
+static int hostPins[256];       ///< Levels set with hostSetPin()
+
+/*! @brief Simulated milliseconds @returns Time since start */
+unsigned long millis(void) { return (unsigned long)(hostMicros / 1000); }
+
+/*! @brief Simulated microseconds, each call takes one @returns Time */
+unsigned long micros(void) { return (unsigned long)(hostMicros++); }
+
+/*! @brief Move simulated time on @param ms Milliseconds */
+void delay(unsigned long ms) { hostMicros += (uint64_t)ms * 1000; }
+
+/*! @brief Move simulated time on @param us Microseconds */
+void delayMicroseconds(unsigned int us) { hostMicros += us; }
+
+/*! @brief Let "other tasks" run for a microsecond */
+void yield(void) { hostMicros++; }
+
+/*! @brief Move simulated time on from a test @param us Microseconds */
+void hostAdvance(uint32_t us) { hostMicros += us; }
+
+/*! @brief Set the level digitalRead() sees @param pin Pin @param value Level
+ */
+void hostSetPin(uint8_t pin, int value) { hostPins[pin] = value; }
+
+/*! @brief Ignored @param pin Pin @param mode Mode */
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+/*! @brief Read a pin @param pin Pin @returns Level set with hostSetPin() */
+int digitalRead(uint8_t pin) { return hostPins[pin]; }
+
+/*! @brief Set a pin @param pin Pin @param value Level */
+void digitalWrite(uint8_t pin, uint8_t value) { hostPins[pin] = value; }
+
+/*! @brief Ignored, there are no edges @param interrupt Interrupt
+ *  @param isr Handler @param mode Edge */
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+  (void)interrupt;
+  (void)isr;
+  (void)mode;
+}
+
+/*! @brief Ignored @param interrupt Interrupt */
+void detachInterrupt(uint8_t interrupt) { (void)interrupt; }
+
+/*!
+    @brief Write a block one byte at a time
+    @param buffer The bytes
+    @param size Number of bytes
+    @returns Bytes written
+*/
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size-- && write(*buffer++))
+    n++;
+  return n;
+}
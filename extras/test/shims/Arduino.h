@@ -0,0 +1,61 @@
+/*!
+ * @file Arduino.h
+ *
+ * Just enough of the Arduino core to build the MPRLS library on a host for
+ * the unit tests and benchmarks. Time is simulated: it moves on when the
+ * code under test waits (delay(), delayMicroseconds(), yield()) and by a
+ * microsecond per micros() call, so a busy loop always gets somewhere
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef MPRLS_HOST_ARDUINO_H
+#define MPRLS_HOST_ARDUINO_H
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean; ///< Arduino's name for bool
+
+#define LOW 0                        ///< Pin level low
+#define HIGH 1                       ///< Pin level high
+#define INPUT 0                      ///< Pin mode input
+#define OUTPUT 1                     ///< Pin mode output
+#define RISING 3                     ///< Interrupt on the rising edge
+#define NOT_AN_INTERRUPT -1          ///< Pin has no interrupt
+#define digitalPinToInterrupt(p) (p) ///< Every pin has an interrupt
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+void hostAdvance(uint32_t us);
+void hostSetPin(uint8_t pin, int value);
+
+/**************************************************************************/
+/*!
+    @brief  Byte sink, the base of Serial and friends
+*/
+/**************************************************************************/
+class Print {
+public:
+  virtual ~Print() {}
+  /*! @brief Write one byte @param c The byte @returns Bytes written */
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,29 @@
+/*!
+ * @file Wire.h
+ *
+ * Placeholder I2C bus for host builds, the tests talk to a simulated sensor
+ * through a transport instead
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef MPRLS_HOST_WIRE_H
+#define MPRLS_HOST_WIRE_H
+
+#include "Arduino.h"
+
+/**************************************************************************/
+/*!
+    @brief  I2C bus without anything on it
+*/
+/**************************************************************************/
+class TwoWire {
+public:
+  /*! @brief Nothing to set up */
+  void begin(void) {}
+};
+
+extern TwoWire Wire;
+
+#endif
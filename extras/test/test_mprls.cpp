@@ -0,0 +1,514 @@
+/*!
+ * @file test_mprls.cpp
+ *
+ * Host unit tests for the MPRLS library, run against the simulated sensor.
+ * Build and run with CMake from this directory:
+ *
+ *     cmake -S . -B build && cmake --build build && ctest --test-dir build
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+
+#include <stdio.h>
+
+#include "Adafruit_MPRLS.h"
+#include "Adafruit_MPRLS_Alarm.h"
+#include "Adafruit_MPRLS_Continuous.h"
+#include "Adafruit_MPRLS_Filter.h"
+#include "Adafruit_MPRLS_Frame.h"
+#include "Adafruit_MPRLS_Manager.h"
+#include "Adafruit_MPRLS_Recovery.h"
+#include "Adafruit_MPRLS_Sim.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);          \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_NEAR(a, b, eps) CHECK(fabs((double)(a) - (double)(b)) <= (eps))
+
+// the default 0-25 PSI part on the 10-90% curve
+static const uint32_t OUT_MIN = 0x19999A;
+static const uint32_t OUT_MAX = 0xE66666;
+static const double FULL_HPA = 25 * PSI_to_HPA;
+
+static uint32_t countsFor(double hpa) {
+  return (uint32_t)(OUT_MIN + hpa / FULL_HPA * (OUT_MAX - OUT_MIN) + 0.5);
+}
+
+static void testConversion(void) {
+  Adafruit_MPRLS mprls;
+
+  CHECK_NEAR(mprls.convertRaw(OUT_MIN), 0, 0.01);
+  CHECK_NEAR(mprls.convertRaw(OUT_MAX), FULL_HPA, 0.01);
+  CHECK_NEAR(mprls.convertRaw(countsFor(1000)), 1000, 0.01);
+  CHECK(isnan(mprls.convertRaw(0xFFFFFFFF)));
+
+  uint32_t raw[3] = {OUT_MIN, 0xFFFFFFFF, OUT_MAX};
+  float hpa[3];
+  mprls.convertRaw(raw, hpa, 3);
+  CHECK_NEAR(hpa[0], 0, 0.01);
+  CHECK(isnan(hpa[1]));
+  CHECK_NEAR(hpa[2], FULL_HPA, 0.01);
+
+  mprls.setUnits(1); // PSI
+  CHECK_NEAR(mprls.convertRaw(OUT_MAX), 25, 0.001);
+
+  CHECK(!mprls.setTransferFunction(10, 10));
+  CHECK_NEAR(mprls.convertRaw(OUT_MAX), 25, 0.001);
+
+  // 15 PSI differential on the 10-90% curve
+  CHECK(mprls.setProfile("MPRLS0015PD00001A"));
+  CHECK_NEAR(mprls.convertRaw(OUT_MIN), -15, 0.001);
+  CHECK_NEAR(mprls.convertRaw(OUT_MAX), 15, 0.001);
+  CHECK(!mprls.setProfile("MPRLSXXXXPA"));
+
+  CHECK_NEAR((Adafruit_MPRLS_T<0, 25>::convertRaw(countsFor(500))), 500,
+             0.01);
+  CHECK(isnan((Adafruit_MPRLS_T<0, 25>::convertRaw(0xFFFFFFFF))));
+  CHECK(sizeof(Adafruit_MPRLS_T<0, 25>) < sizeof(Adafruit_MPRLS));
+}
+
+static void testFixedPoint(void) {
+  Adafruit_MPRLS mprls;
+  const double fullScale = 25 * (double)(float)PSI_to_HPA; // K is a float
+
+  // within a couple of Q16.16 LSBs of the exact transfer function
+  for (uint32_t raw = OUT_MIN; raw <= OUT_MAX; raw += 99991) {
+    double expect =
+        (double)(raw - OUT_MIN) / (OUT_MAX - OUT_MIN) * fullScale * 65536.0;
+    CHECK_NEAR(mprls.convertRawFixed(raw), expect, 2);
+  }
+  CHECK(mprls.convertRawFixed(0xFFFFFFFF) == MPRLS_FIXED_INVALID);
+
+  uint32_t raw[2] = {OUT_MAX, 0xFFFFFFFF};
+  int32_t fixed[2];
+  mprls.convertRawFixed(raw, fixed, 2);
+  CHECK_NEAR(fixed[0] / 65536.0, FULL_HPA, 0.001);
+  CHECK(fixed[1] == MPRLS_FIXED_INVALID);
+
+  // a falling curve takes the negative gain path
+  CHECK(mprls.setTransferFunction(25, 0));
+  for (uint32_t counts = OUT_MIN; counts <= OUT_MAX; counts += 99991) {
+    double expect =
+        (double)(OUT_MAX - counts) / (OUT_MAX - OUT_MIN) * fullScale * 65536.0;
+    CHECK_NEAR(mprls.convertRawFixed(counts), expect, 2);
+  }
+}
+
+/** Sleep callback that bumps the first averaged reading by 7 counts */
+static void bumpFirstSleep(uint32_t us, void *arg) {
+  static bool bumped = false;
+  hostAdvance(us);
+  ((Adafruit_MPRLS_Sim *)arg)->setRaw(bumped ? 0x800000 : 0x800007);
+  bumped = true;
+}
+
+static void testAveraged(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+  // zero at half scale, so the fraction isn't swamped by the offset
+  CHECK(mprls.setProfile("MPRLS0015PD00001A"));
+  mprls.setUnits(1);
+  double gain = 30.0 / (OUT_MAX - OUT_MIN);
+
+  sim.setRaw(0x800000);
+  CHECK_NEAR(mprls.readPressureAveraged(4), mprls.convertRaw(0x800000), 0);
+  CHECK(mprls.readRawOversampled(4) == 0x800000);
+
+  // the sum is past 2^24, the 7/16 of a count still has to come through
+  mprls.setSleepCallback(bumpFirstSleep, &sim);
+  float averaged = mprls.readPressureAveraged(16);
+  mprls.setSleepCallback(NULL);
+  CHECK_NEAR(averaged - mprls.convertRaw(0x800000), 7 / 16.0 * gain,
+             0.05 * gain);
+}
+
+static void testQueue(void) {
+  mprls_sample_t storage[4];
+  Adafruit_MPRLS_SampleQueue queue(storage, 4);
+  mprls_sample_t sample = {0, 0, 0, 0};
+
+  CHECK(queue.available() == 0);
+  CHECK(!queue.pop(&sample));
+  for (uint16_t i = 0; i < 3; i++) {
+    sample.sequence = i;
+    CHECK(queue.push(sample));
+  }
+  CHECK(!queue.push(sample)); // one slot stays free
+  CHECK(queue.available() == 3);
+
+  CHECK(queue.pop(&sample) && sample.sequence == 0);
+  mprls_sample_t out[4];
+  CHECK(queue.pop(out, 4) == 2);
+  CHECK(out[0].sequence == 1 && out[1].sequence == 2);
+
+  // wrap around with a block push
+  mprls_sample_t block[3];
+  for (uint16_t i = 0; i < 3; i++)
+    block[i].sequence = 10 + i;
+  CHECK(queue.push(block, 3) == 3);
+  CHECK(queue.pop(out, 4) == 3);
+  CHECK(out[0].sequence == 10 && out[2].sequence == 12);
+
+  queue.push(sample);
+  queue.clear();
+  CHECK(queue.available() == 0);
+}
+
+static void testFilter(void) {
+  Adafruit_MPRLS_Filter median;
+  CHECK(!median.setMedianWindow(MPRLS_FILTER_MAX_WINDOW + 2));
+  CHECK(median.setMedianWindow(3));
+  median.process(1000);
+  median.process(1000);
+  CHECK(median.process(900000) == 1000); // spike rejected
+  CHECK(median.process(1010) == 1010);
+
+  Adafruit_MPRLS_Filter ema;
+  ema.setEMA(0.5);
+  CHECK(ema.process(1000) == 1000); // first sample primes it
+  CHECK_NEAR(ema.process(2000), 1500, 1);
+  CHECK_NEAR(ema.process(2000), 1750, 1);
+  ema.reset();
+  CHECK(ema.process(4000) == 4000);
+}
+
+static uint8_t alarmCalls = 0;
+
+static void onAlarm(uint8_t alarms, uint32_t raw, void *arg) {
+  (void)alarms;
+  (void)raw;
+  (void)arg;
+  alarmCalls++;
+}
+
+static void testAlarm(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  Adafruit_MPRLS_Alarm alarm(&mprls);
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+  mprls.setAlarm(&alarm);
+  alarm.setCallback(onAlarm);
+  CHECK(alarm.setHigh(1000, 100));
+  CHECK(alarm.setLow(200));
+
+  sim.setRaw(countsFor(500));
+  CHECK(mprls.readResult().error == MPRLS_OK);
+  CHECK(alarm.active() == 0);
+
+  sim.setRaw(countsFor(1100));
+  mprls.readResult();
+  CHECK(alarm.active() == MPRLS_ALARM_HIGH);
+  sim.setRaw(countsFor(950)); // inside the hysteresis
+  mprls.readResult();
+  CHECK(alarm.active() == MPRLS_ALARM_HIGH);
+  sim.setRaw(countsFor(850));
+  mprls.readResult();
+  CHECK(alarm.active() == 0);
+
+  sim.setRaw(countsFor(100));
+  mprls.readResult();
+  CHECK(alarm.active() == MPRLS_ALARM_LOW);
+  alarm.disable(MPRLS_ALARM_LOW);
+  CHECK(alarm.active() == 0);
+  CHECK(alarmCalls == 3); // high, cleared, low
+
+  // failed reads are never checked
+  uint8_t calls = alarmCalls;
+  sim.setRaw(countsFor(1500));
+  sim.nack(0xFF);
+  mprls.readResult();
+  sim.nack(0);
+  CHECK(alarmCalls == calls && alarm.active() == 0);
+
+  // beyond the sensor's range it saturates, which must still raise them
+  sim.setStatusFlags(MPRLS_STATUS_MATHSAT);
+  sim.setRaw(0xFFFFFF);
+  CHECK(mprls.readResult().error == MPRLS_ERR_MATHSAT);
+  CHECK(alarm.active() == MPRLS_ALARM_HIGH);
+  alarm.setLow(200);
+  sim.setRaw(0);
+  mprls.readResult();
+  CHECK(alarm.active() == MPRLS_ALARM_LOW);
+  sim.setStatusFlags(0);
+  sim.setRaw(countsFor(500));
+  mprls.readResult();
+  CHECK(alarm.active() == 0);
+}
+
+static void testSimErrors(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+
+  sim.setRaw(0x123456);
+  mprls_result_t result = mprls.readResult();
+  CHECK(result.error == MPRLS_OK && result.raw == 0x123456);
+  CHECK(mprls.lastPollCount() >= 1 && mprls.lastPollCount() <= 3);
+
+  sim.setStatusFlags(MPRLS_STATUS_MATHSAT);
+  CHECK(mprls.readResult().error == MPRLS_ERR_MATHSAT);
+  sim.setStatusFlags(MPRLS_STATUS_FAILED);
+  CHECK(mprls.readResult().error == MPRLS_ERR_FAILED);
+  sim.setStatusFlags(0);
+
+  sim.nack(1);
+  CHECK(mprls.readResult().error == MPRLS_ERR_I2C);
+
+  sim.setConversionTime(1000000);
+  CHECK(mprls.readResult().error == MPRLS_ERR_TIMEOUT);
+  sim.setConversionTime(MPRLS_CONVERSION_TIME_US);
+  hostAdvance(1000000); // let the abandoned conversion finish
+  CHECK(mprls.readResult().error == MPRLS_OK);
+
+  // failed reads still get their own sequence number
+  mprls_sample_t a, b;
+  CHECK(mprls.readSample(&a));
+  sim.nack(1);
+  CHECK(!mprls.readSample(&b));
+  CHECK(mprls.readSample(&b));
+  CHECK((uint16_t)(b.sequence - a.sequence) == 2);
+}
+
+/** Sleep callback that unplugs the sensor while the conversion runs */
+static void unplugSleep(uint32_t us, void *arg) {
+  hostAdvance(us);
+  ((Adafruit_MPRLS_Sim *)arg)->nack(0xFF);
+}
+
+static void testPollFailure(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+
+  // a NACK on a status poll ends the conversion, it doesn't look busy
+  CHECK(mprls.startConversion());
+  sim.nack(1);
+  CHECK(!mprls.isReady());
+  CHECK(!mprls.conversionPending());
+  CHECK(mprls.lastError() == MPRLS_ERR_I2C);
+
+  // and the blocking read reports it without waiting for the timeout
+  mprls.setSleepCallback(unplugSleep, &sim);
+  uint32_t start = micros();
+  CHECK(mprls.readResult().error == MPRLS_ERR_I2C);
+  CHECK(micros() - start < MPRLS_CONVERSION_TIME_US + 100);
+  mprls.setSleepCallback(NULL);
+  sim.nack(0);
+
+  mprls.setMergedRead(true);
+  CHECK(mprls.startConversion());
+  sim.nack(1);
+  CHECK(!mprls.isReady() && mprls.lastError() == MPRLS_ERR_I2C);
+}
+
+static void testTimeout(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+
+  // a timeout shorter than the initial wait cuts the wait short
+  sim.setConversionTime(1000000);
+  mprls.setTimeout(1000);
+  uint32_t start = micros();
+  CHECK(mprls.readResult().error == MPRLS_ERR_TIMEOUT);
+  CHECK(micros() - start < 1100);
+
+  mprls.setTimeout(3000);
+  mprls.setPollingStrategy(0, 2000);
+  start = micros();
+  CHECK(mprls.readResult().error == MPRLS_ERR_TIMEOUT);
+  CHECK(micros() - start < 3100);
+}
+
+static void testHealth(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+  mprls.setFailureThreshold(2);
+
+  sim.nack(0xFF);
+  mprls.readResult();
+  CHECK(mprls.isHealthy());
+  mprls.readResult();
+  CHECK(!mprls.isHealthy());
+
+  // fails fast without touching the bus
+  uint32_t reads = sim.reads(), writes = sim.writes();
+  CHECK(mprls.readResult().error == MPRLS_ERR_UNHEALTHY);
+  CHECK(sim.reads() == reads && sim.writes() == writes);
+
+  // back on the bus, found again by the periodic probe
+  sim.nack(0);
+  delay(MPRLS_PROBE_INTERVAL_MS + 1);
+  CHECK(mprls.readResult().error == MPRLS_OK);
+  CHECK(mprls.isHealthy());
+
+  // a sensor that is missing at begin() is not healthy
+  Adafruit_MPRLS_Sim missing;
+  Adafruit_MPRLS absent;
+  absent.setTransport(&missing);
+  missing.nack(0xFF);
+  CHECK(!absent.begin());
+  CHECK(!absent.isHealthy());
+}
+
+static void testRecovery(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  Adafruit_MPRLS_Recovery recovery(&mprls);
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+  mprls.setFailureThreshold(1);
+
+  sim.nack(0xFF);
+  mprls.readResult();
+  CHECK(!mprls.isHealthy());
+  CHECK(recovery.service() == MPRLS_RECOVERY_RESETTING);
+  delay(MPRLS_STARTUP_MS + 1);
+  CHECK(recovery.service() == MPRLS_RECOVERY_BACKOFF);
+
+  // a probe brings it back before the backoff is up, no reset follows
+  sim.nack(0);
+  CHECK(mprls.probe());
+  CHECK(recovery.service() == MPRLS_RECOVERY_HEALTHY);
+  CHECK(mprls.isHealthy() && recovery.recoveries() == 1);
+  CHECK(mprls.readResult().error == MPRLS_OK);
+}
+
+static void testEOC(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls(-1, 5); // any pin, the model drives EOC
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+
+  uint32_t reads = sim.reads();
+  CHECK(mprls.readResult().error == MPRLS_OK);
+  CHECK(mprls.lastPollCount() == 0);
+  CHECK(sim.reads() - reads == 1);    // just the result
+  CHECK(!mprls.enableEOCInterrupt()); // no edge to interrupt on
+}
+
+static void testManager(void) {
+  Adafruit_MPRLS_Sim sim[3];
+  Adafruit_MPRLS sensor[3];
+  Adafruit_MPRLS_Manager manager;
+
+  for (uint8_t i = 0; i < 3; i++) {
+    sensor[i].setTransport(&sim[i]);
+    sim[i].setRaw(0x100000 * (i + 1));
+    CHECK(manager.addSensor(&sensor[i]) == i);
+  }
+  sim[2].nack(0xFF);
+  CHECK(manager.beginAll() == 2);
+  sim[2].nack(0);
+
+  uint32_t raw[3];
+  uint32_t reads = sim[0].reads();
+  CHECK(manager.readAll(raw) >= 2);
+  CHECK(raw[0] == 0x100000 && raw[1] == 0x200000);
+  CHECK(sim[0].reads() - reads <= 3); // paced, not spinning on status
+}
+
+static void testContinuous(void) {
+  Adafruit_MPRLS_Sim sim;
+  Adafruit_MPRLS mprls;
+  mprls.setTransport(&sim);
+  CHECK(mprls.begin());
+
+  mprls_sample_t storage[16];
+  Adafruit_MPRLS_SampleQueue queue(storage, 16);
+  Adafruit_MPRLS_Continuous engine(&mprls, &queue);
+  uint32_t reads = sim.reads();
+  CHECK(engine.start());
+  while (queue.available() < 10)
+    engine.service();
+  // paced by the polling strategy, not a status read per call
+  CHECK(sim.reads() - reads <= 10 * 3);
+  CHECK(engine.errors() == 0);
+
+  // an unhealthy sensor is retried at the probe period, not every call
+  mprls.setFailureThreshold(1);
+  sim.nack(0xFF);
+  mprls_sample_t before, after;
+  CHECK(!mprls.readSample(&before));
+  for (uint16_t i = 0; i < 1000; i++) {
+    engine.service();
+    hostAdvance(250);
+  }
+  CHECK(engine.errors() <= 1);
+  sim.nack(0);
+  delay(MPRLS_PROBE_INTERVAL_MS + 1);
+  CHECK(mprls.readSample(&after));
+  CHECK((uint16_t)(after.sequence - before.sequence) <= 5);
+}
+
+static void testFrame(void) {
+  Adafruit_MPRLS_FrameEncoder encoder(7);
+  mprls_sample_t sample = {0x123456, 1000, 0x0102, MPRLS_STATUS_POWERED};
+  uint8_t frame[MPRLS_FRAME_MAX_LEN];
+
+  CHECK(encoder.encode(sample, frame) == MPRLS_FRAME_KEY_LEN);
+  CHECK(frame[0] == MPRLS_FRAME_KEY && frame[1] == 7 && frame[2] == 0x02);
+  CHECK(frame[3] == 0x12 && frame[4] == 0x34 && frame[5] == 0x56);
+  CHECK(frame[6] == (1000 & 0xFF) && frame[7] == (1000 >> 8));
+  CHECK(Adafruit_MPRLS_FrameEncoder::crc8(frame, 10) == frame[10]);
+
+  sample.timestamp += 500;
+  sample.sequence++;
+  CHECK(encoder.encode(sample, frame) == MPRLS_FRAME_DELTA_LEN);
+  CHECK(frame[0] == MPRLS_FRAME_DELTA && frame[2] == 0x03);
+  CHECK(frame[6] == (500 & 0xFF) && frame[7] == (500 >> 8));
+  CHECK(Adafruit_MPRLS_FrameEncoder::crc8(frame, 8) == frame[8]);
+
+  // a failed conversion left a gap, the host gets a fresh timestamp
+  sample.timestamp += 500;
+  sample.sequence += 2;
+  CHECK(encoder.encode(sample, frame) == MPRLS_FRAME_KEY_LEN);
+  CHECK(frame[2] == 0x05);
+
+  // the low byte wraps without a gap
+  sample.sequence = 0x01FF;
+  encoder.encode(sample, frame);
+  sample.sequence++;
+  CHECK(encoder.encode(sample, frame) == MPRLS_FRAME_DELTA_LEN);
+  CHECK(frame[2] == 0x00);
+}
+
+int main(void) {
+  testConversion();
+  testFixedPoint();
+  testAveraged();
+  testQueue();
+  testFilter();
+  testAlarm();
+  testSimErrors();
+  testPollFailure();
+  testTimeout();
+  testHealth();
+  testRecovery();
+  testEOC();
+  testManager();
+  testContinuous();
+  testFrame();
+
+  if (failures)
+    printf("%d check(s) failed\n", failures);
+  else
+    printf("all tests passed\n");
+  return failures ? 1 : 0;
+}